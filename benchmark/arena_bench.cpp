@@ -0,0 +1,64 @@
+#include "mempool.h"
+#include "memarena.h"
+#include "allocator.h"
+#include "trie.h"
+#include "vector.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+MemPool *mem_pool = new MemPool(64, 1 << 22, FIRST_FIT);
+
+static constexpr int REQUESTS = 200;
+static constexpr int WORDS    = 2000;
+
+// @brief 一次请求：建一棵字典树和几个数组，用完整体丢弃
+template<class Alloc>
+static long long request (const std::vector<std::string>& words, const Alloc& alloc) {
+	using IntAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<int>;
+	zyz::Trie<int, IntAlloc> trie{IntAlloc(alloc)};
+	zyz::Vector<int, IntAlloc> lengths{IntAlloc(alloc)};
+	zyz::Vector<int, IntAlloc> hits{IntAlloc(alloc)};
+	for (int i = 0; i < WORDS; i ++) {
+		trie.insert(words[i], i);
+		lengths.push_back((int)words[i].size());
+	}
+	for (int i = 0; i < WORDS; i += 3)
+		hits.push_back(trie.count(words[i]));
+	return (long long)lengths.size() + hits.size();
+}
+
+int main () {
+	std::mt19937 rng(42);
+	std::vector<std::string> words(WORDS);
+	for (auto& w : words) {
+		w.resize(4 + rng() % 8);
+		for (char& c : w)
+			c = (char)('a' + rng() % 26);
+	}
+	long long sink = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < REQUESTS; r ++)
+		sink += request(words, zyz::Allocator<int>());
+	std::chrono::duration<double, std::milli> pooled = std::chrono::steady_clock::now() - start;
+
+	MemArena arena(mem_pool);
+	start = std::chrono::steady_clock::now();
+	for (int r = 0; r < REQUESTS; r ++) {
+		sink += request(words, zyz::ArenaAllocator<int>(&arena));
+		arena.reset();
+	}
+	std::chrono::duration<double, std::milli> arenaCost = std::chrono::steady_clock::now() - start;
+
+	std::cout.setf(std::ios::left);
+	std::cout << std::setw(20) << "(ms/request)" << std::setw(16) << "MemPool" << std::setw(16) << "MemArena" << std::endl;
+	std::cout << std::setw(20) << "trie+vector" << std::setw(16) << pooled.count() / REQUESTS
+			  << std::setw(16) << arenaCost.count() / REQUESTS << std::endl;
+	std::cout << "arena reserved: " << arena.getReservedBytes() << " bytes" << std::endl;
+	return sink == 0;
+}
@@ -0,0 +1,77 @@
+#include "mempool.h"
+#include "allocator.h"
+#include "trie.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+MemPool *mem_pool = new MemPool(16, 1 << 22, TLSF_FIT);
+
+static constexpr int     ROUNDS = 20;
+static constexpr int     BLOCKS = 20000;
+static constexpr ssize_t SIZE   = 640;	///< 超出线程缓存与 slab 的范围，落在空闲链表上
+
+// @brief 逐块配置，打乱后逐块回收
+static double single (MemPool &pool) {
+	std::vector<void*> blocks(BLOCKS);
+	std::mt19937 rng(1);
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < ROUNDS; r ++) {
+		for (int i = 0; i < BLOCKS; i ++)
+			blocks[i] = pool.allocate(SIZE);
+		std::shuffle(blocks.begin(), blocks.end(), rng);
+		for (int i = 0; i < BLOCKS; i ++)
+			pool.deallocate((uint8_t *)blocks[i], SIZE);
+	}
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+// @brief 同样的工作，改用 allocateBatch / deallocateBatch
+static double batch (MemPool &pool) {
+	std::vector<void*> blocks(BLOCKS);
+	std::vector<ssize_t> sizes(BLOCKS, SIZE);
+	std::mt19937 rng(1);
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < ROUNDS; r ++) {
+		pool.allocateBatch(BLOCKS, SIZE, blocks.data());
+		std::shuffle(blocks.begin(), blocks.end(), rng);
+		pool.deallocateBatch(blocks.data(), sizes.data(), BLOCKS);
+	}
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+// @brief 字典树的构建与整体释放（节点批量配置、析构时批量回收）
+static double trie () {
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < ROUNDS / 4; r ++) {
+		zyz::Trie<int> t;
+		for (int i = 0; i < BLOCKS; i ++)
+			t[std::to_string(i * 7919)] = i;
+	}
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+// @brief 对比逐块与批量的 配置/回收，各分配算法分别测试
+int main () {
+	std::pair<const char*, int> algorithms[] = {
+		{"FIRST_FIT", FIRST_FIT},
+		{"BEST_FIT", BEST_FIT},
+		{"WORST_FIT", WORST_FIT},
+		{"TLSF_FIT", TLSF_FIT},
+	};
+	std::cout.setf(std::ios::left);
+	std::cout << std::setw(16) << "(ms)" << std::setw(16) << "single" << std::setw(16) << "batch" << std::endl;
+	for (auto& [name, algorithm] : algorithms) {
+		MemPool pool(16, 1 << 22, algorithm);
+		std::cout << std::setw(16) << name << std::setw(16) << single(pool) << std::setw(16) << batch(pool) << std::endl;
+	}
+	std::cout << std::setw(16) << "Trie" << trie() << std::endl;
+}
@@ -0,0 +1,51 @@
+#include "mempool.h"
+#include "vector.h"
+#include "algorithm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+MemPool *mem_pool = new MemPool(32, 1 << 24, TLSF_FIT);
+
+static constexpr int N = 1 << 25;
+
+static double since (std::chrono::steady_clock::time_point start) {
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+// @brief 1 到 max(硬件线程数, 8) 个线程排序 N 个随机整数的耗时与加速比
+int main () {
+	zyz::Vector<int> input;
+	input.reserve(N);
+	std::mt19937 rng(7);
+	for (int i = 0; i < N; i ++)
+		input.push_back((int)rng());
+
+	int hardware = (int)std::thread::hardware_concurrency();
+	std::cout.setf(std::ios::left);
+	std::cout << "hardware threads: " << hardware << ", " << N << " ints" << std::endl;
+	std::cout << std::setw(16) << "threads" << std::setw(14) << "ms" << "speedup" << std::endl;
+
+	zyz::Vector<int> v(input);
+	auto start = std::chrono::steady_clock::now();
+	zyz::sort(zyz::execution::seq, v.begin(), v.end());
+	double sequential = since(start);
+	std::cout << std::setw(16) << "seq" << std::setw(14) << sequential << 1.0 << std::endl;
+
+	for (int threads = 1; threads <= std::max(hardware, 8); threads *= 2) {
+		zyz::Vector<int> w(input);
+		start = std::chrono::steady_clock::now();
+		zyz::sort(zyz::execution::parallel_policy(threads), w.begin(), w.end());
+		double cost = since(start);
+		bool same = true;
+		for (int i = 0; i < N; i ++)
+			same &= v[i] == w[i];
+		std::cout << std::setw(16) << threads << std::setw(14) << cost << sequential / cost
+			<< (same ? "" : "  MISMATCH") << std::endl;
+	}
+}
@@ -0,0 +1,69 @@
+#include "mempool.h"
+#include "persistentpool.h"
+#include "trie.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+MemPool *mem_pool = new MemPool(32, 1 << 24, TLSF_FIT);
+
+static constexpr int     KEYS       = 100000;
+static constexpr ssize_t POOL_BYTES = 1l << 29;
+static const char*       POOL_FILE  = "persistent_bench.pool";
+
+using PersistentTrie = zyz::Trie<int, zyz::PersistentAllocator<int>>;
+
+static double since (std::chrono::steady_clock::time_point start) {
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+// @brief 在内存池上从头构建索引（即重启时的重建）
+static double rebuild () {
+	auto start = std::chrono::steady_clock::now();
+	zyz::Trie<int> t;
+	for (int i = 0; i < KEYS; i ++)
+		t[std::to_string(i * 7919)] = i;
+	return since(start);
+}
+
+// @brief 在持久化内存池上构建同样的索引并登记为根
+static double build () {
+	auto start = std::chrono::steady_clock::now();
+	PersistentPool pool(POOL_FILE, POOL_BYTES);
+	PersistentTrie t{zyz::PersistentAllocator<int>(&pool)};
+	for (int i = 0; i < KEYS; i ++)
+		t[std::to_string(i * 7919)] = i;
+	pool.setRoot("index", t.release());
+	return since(start);
+}
+
+// @brief 重新打开文件并接管索引，做 queries 次查询
+static double reopen (int queries) {
+	auto start = std::chrono::steady_clock::now();
+	PersistentPool pool(POOL_FILE, POOL_BYTES);
+	PersistentTrie t(zyz::PersistentAllocator<int>(&pool), pool.getRoot("index"));
+	long sum = 0;
+	for (int i = 0; i < queries; i ++)
+		sum += *t.query(std::to_string(i % KEYS * 7919));
+	if (sum < 0)
+		std::cout << sum;
+	t.release();
+	return since(start);
+}
+
+// @brief 对比重启时重建索引与映射文件后直接接管
+int main () {
+	remove(POOL_FILE);
+	std::cout.setf(std::ios::left);
+	std::cout << std::setw(28) << "(ms)" << KEYS << " keys" << std::endl;
+	std::cout << std::setw(28) << "rebuild (MemPool)" << rebuild() << std::endl;
+	std::cout << std::setw(28) << "build (PersistentPool)" << build() << std::endl;
+	std::cout << std::setw(28) << "reopen + attach" << reopen(0) << std::endl;
+	std::cout << std::setw(28) << "reopen + 1000 queries" << reopen(1000) << std::endl;
+	std::cout << std::setw(28) << "reopen + all queries" << reopen(KEYS) << std::endl;
+	remove(POOL_FILE);
+}
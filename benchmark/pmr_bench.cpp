@@ -0,0 +1,94 @@
+#include "mempool.h"
+#include "memresource.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+MemPool *mem_pool = new MemPool(256, 1 << 20, TLSF_FIT);
+
+static constexpr int ROUNDS = 200;
+
+// @brief 反复增长 std::pmr::vector
+static void vectorWork (std::pmr::memory_resource* resource) {
+	for (int r = 0; r < ROUNDS; r ++) {
+		std::pmr::vector<int> v(resource);
+		for (int i = 0; i < 10000; i ++)
+			v.push_back(i);
+	}
+}
+
+// @brief std::pmr::unordered_map 插入后逐个删除
+static void mapWork (std::pmr::memory_resource* resource) {
+	for (int r = 0; r < ROUNDS / 10; r ++) {
+		std::pmr::unordered_map<int, int> m(resource);
+		for (int i = 0; i < 10000; i ++)
+			m[i * 7] = i;
+		for (int i = 0; i < 10000; i ++)
+			m.erase(i * 7);
+	}
+}
+
+// @brief 大量短命的 std::pmr::string
+static void stringWork (std::pmr::memory_resource* resource) {
+	for (int r = 0; r < ROUNDS / 10; r ++) {
+		std::pmr::vector<std::pmr::string> v(resource);
+		for (int i = 0; i < 5000; i ++)
+			v.emplace_back(std::string(24 + i % 200, 'a' + i % 26));
+	}
+}
+
+// @brief 超对齐（64 字节）的元素
+static void alignedWork (std::pmr::memory_resource* resource) {
+	struct alignas(64) Line { int value[16]; };
+	for (int r = 0; r < ROUNDS; r ++) {
+		std::pmr::vector<Line*> v(resource);
+		std::pmr::polymorphic_allocator<Line> alloc(resource);
+		for (int i = 0; i < 1000; i ++)
+			v.push_back(alloc.allocate(1));
+		for (Line* p : v)
+			alloc.deallocate(p, 1);
+	}
+}
+
+// @brief 运行 work，返回毫秒
+static double run (void (*work)(std::pmr::memory_resource*), std::pmr::memory_resource* resource) {
+	auto start = std::chrono::steady_clock::now();
+	work(resource);
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+// @brief 单线程对比 new_delete_resource、unsynchronized_pool_resource 与内存池资源
+int main () {
+	std::pmr::unsynchronized_pool_resource unsynchronized;
+	MemPoolResource pooled(mem_pool);
+	CachedMemPoolResource cached(mem_pool);
+	std::pair<const char*, std::pmr::memory_resource*> resources[] = {
+		{"new_delete", std::pmr::new_delete_resource()},
+		{"unsync_pool", &unsynchronized},
+		{"MemPool", &pooled},
+		{"MemPool+cache", &cached},
+	};
+	std::pair<const char*, void (*)(std::pmr::memory_resource*)> works[] = {
+		{"vector", vectorWork},
+		{"unordered_map", mapWork},
+		{"string", stringWork},
+		{"aligned(64)", alignedWork},
+	};
+	std::cout.setf(std::ios::left);
+	std::cout << std::setw(16) << "(ms)";
+	for (auto& [name, resource] : resources)
+		std::cout << std::setw(16) << name;
+	std::cout << std::endl;
+	for (auto& [workName, work] : works) {
+		std::cout << std::setw(16) << workName;
+		for (auto& [name, resource] : resources)
+			std::cout << std::setw(16) << run(work, resource);
+		std::cout << std::endl;
+	}
+}
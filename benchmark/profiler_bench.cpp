@@ -0,0 +1,64 @@
+#include "mempool.h"
+#include "allocator.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+MemPool *mem_pool = new MemPool(64, 1 << 20, TLSF_FIT);
+
+static constexpr int ROUNDS = 200000;
+static constexpr int BURST  = 16;
+
+// @brief 经过线程缓存的小对象与直接走内存池的中等对象各半
+static void work () {
+	zyz::Allocator<long> alloc;
+	long* small[BURST];
+	uint8_t* medium[BURST];
+	for (int r = 0; r < ROUNDS; r ++) {
+		for (int i = 0; i < BURST; i ++) {
+			small[i] = alloc.allocate(1 + i % 8);
+			medium[i] = (uint8_t *)mem_pool->allocate(512 + 64 * i);
+		}
+		for (int i = 0; i < BURST; i ++) {
+			alloc.deallocate(small[i], 1 + i % 8);
+			mem_pool->deallocate(medium[i], 512 + 64 * i);
+		}
+	}
+}
+
+// @brief 挂上 profiler（nullptr 表示不挂）跑一遍，返回每次 配置+回收 的纳秒数
+static double run (MemProfiler* profiler) {
+	mem_pool->setProfiler(profiler);
+	auto start = std::chrono::steady_clock::now();
+	work();
+	std::chrono::duration<double, std::nano> cost = std::chrono::steady_clock::now() - start;
+	mem_pool->setProfiler(nullptr);
+	return cost.count() / ((double)ROUNDS * BURST * 2);
+}
+
+// @brief 不同采样间隔下的开销；最后打印一份折叠栈的开头
+int main () {
+	std::cout.setf(std::ios::left);
+	std::cout << std::setw(24) << "profiler" << "ns/op" << std::endl;
+	std::cout << std::setw(24) << "disabled" << run(nullptr) << std::endl;
+	for (ssize_t interval : {512 << 10, 64 << 10, 4 << 10}) {
+		MemProfiler profiler(interval);
+		std::string name = "interval " + std::to_string(interval);
+		std::cout << std::setw(24) << name << run(&profiler) << std::endl;
+	}
+	MemProfiler profiler(4 << 10);
+	mem_pool->setProfiler(&profiler);
+	std::vector<void*> live;
+	for (int i = 0; i < 10000; i ++)
+		live.push_back(mem_pool->allocate(1000));
+	std::ostringstream folded;
+	profiler.dumpFolded(folded);
+	std::cout << "live samples: " << profiler.getLiveSamples() << ", estimated live bytes: " << (long)profiler.estimateLiveBytes()
+		<< " (actual " << 10000 * 1000 << ")" << std::endl << folded.str().substr(0, 400) << std::endl;
+	for (void* p : live)
+		mem_pool->deallocate((uint8_t *)p, 1000);
+	mem_pool->setProfiler(nullptr);
+}
@@ -0,0 +1,91 @@
+#include "mempool.h"
+#include "vector.h"
+#include "algorithm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+
+MemPool *mem_pool = new MemPool(32, 1 << 24, TLSF_FIT);
+
+static double since (std::chrono::steady_clock::time_point start) {
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+// @brief n 个随机数；浮点数正负各半
+template<class T>
+static zyz::Vector<T> randomValues (int n) {
+	std::mt19937_64 rng(42);
+	zyz::Vector<T> v;
+	v.reserve(n);
+	for (int i = 0; i < n; i ++) {
+		if constexpr (std::is_floating_point_v<T>)
+			v.push_back((T)((double)(int64_t)rng() / 1e12));
+		else
+			v.push_back((T)rng());
+	}
+	return v;
+}
+
+// @brief 重复 rounds 次的平均耗时
+template<class Vec, class Sort>
+static double timeSort (const Vec& input, int rounds, Sort sort) {
+	double cost = 0;
+	for (int r = 0; r < rounds; r ++) {
+		Vec v(input);
+		auto start = std::chrono::steady_clock::now();
+		sort(v);
+		cost += since(start);
+		if (!std::is_sorted(v.begin(), v.end()))
+			std::cout << "NOT SORTED ";
+	}
+	return cost / rounds;
+}
+
+template<class T>
+static void run (const std::string& name, int n) {
+	zyz::Vector<T> input = randomValues<T>(n);
+	int rounds = std::max(1, 1000000 / n);
+	using Vec = zyz::Vector<T>;
+	std::cout << std::setw(22) << name + " " + std::to_string(n)
+		<< std::setw(12) << timeSort(input, rounds, [] (Vec& v) { zyz::radix_sort(v.begin(), v.end()); })
+		<< std::setw(12) << timeSort(input, rounds, [] (Vec& v) { zyz::radix_sort<16>(v.begin(), v.end()); })
+		// 比较函数不是 zyz::less 时 zyz::sort 不会转去基数排序，即原来的 pdqsort
+		<< std::setw(12) << timeSort(input, rounds, [] (Vec& v) { zyz::sort(v.begin(), v.end(), [] (T a, T b) { return a < b; }); })
+		<< timeSort(input, rounds, [] (Vec& v) { std::sort(v.begin(), v.end()); }) << std::endl;
+}
+
+// @brief 基数排序（8 位 / 16 位一趟）与 pdqsort、std::sort 的耗时（毫秒）
+int main () {
+	std::cout.setf(std::ios::left);
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << std::setw(22) << "(ms)" << std::setw(12) << "radix<8>" << std::setw(12) << "radix<16>"
+		<< std::setw(12) << "pdqsort" << "std::sort" << std::endl;
+	for (int n : {256, 1024, 4096, 65536, 1000000}) {
+		run<int32_t>("int32", n);
+		run<uint64_t>("uint64", n);
+		run<float>("float", n);
+		run<double>("double", n);
+	}
+
+	// 字符串：MSD 基数排序
+	std::mt19937 rng(42);
+	zyz::Vector<std::string> words;
+	for (int i = 0; i < 250000; i ++) {
+		std::string s;
+		for (int len = 3 + rng() % 10; len > 0; len --)
+			s += (char)('a' + rng() % 26);
+		words.push_back(s);
+	}
+	using Strings = zyz::Vector<std::string>;
+	std::cout << std::setw(22) << "string 250000"
+		<< std::setw(12) << timeSort(words, 1, [] (Strings& v) { zyz::radix_sort(v.begin(), v.end()); })
+		<< std::setw(12) << "-"
+		<< std::setw(12) << timeSort(words, 1, [] (Strings& v) { zyz::sort(v.begin(), v.end()); })
+		<< timeSort(words, 1, [] (Strings& v) { std::sort(v.begin(), v.end()); }) << std::endl;
+}
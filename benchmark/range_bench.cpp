@@ -0,0 +1,130 @@
+#include "mempool.h"
+#include "vector.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+MemPool *mem_pool = new MemPool(32, 1 << 24, TLSF_FIT);
+
+static constexpr int CHUNK  = 256;
+static constexpr int CHUNKS = 4000;
+static constexpr int BASE   = 20000;
+static constexpr int EDITS  = 2000;
+
+static double since (std::chrono::steady_clock::time_point start) {
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+template<class T>
+static std::vector<T> source (int n);
+
+template<>
+std::vector<int> source (int n) {
+	std::vector<int> ret;
+	for (int i = 0; i < n; i ++)
+		ret.push_back(i);
+	return ret;
+}
+
+template<>
+std::vector<std::string> source (int n) {
+	std::vector<std::string> ret;
+	for (int i = 0; i < n; i ++)
+		ret.push_back(std::string(24, 'a' + i % 26));
+	return ret;
+}
+
+// @brief 逐块追加：循环 push_back 与一次追加整段
+template<class T>
+static void appendChunks (const std::string& type) {
+	std::vector<T> chunk = source<T>(CHUNK);
+	auto start = std::chrono::steady_clock::now();
+	zyz::Vector<T> a;
+	for (int c = 0; c < CHUNKS; c ++)
+		for (const T& x : chunk)
+			a.push_back(x);
+	double loop = since(start);
+	start = std::chrono::steady_clock::now();
+	zyz::Vector<T> b;
+	for (int c = 0; c < CHUNKS; c ++)
+		b.append(chunk.begin(), chunk.end());
+	double bulk = since(start);
+	start = std::chrono::steady_clock::now();
+	std::vector<T> s;
+	for (int c = 0; c < CHUNKS; c ++)
+		s.insert(s.end(), chunk.begin(), chunk.end());
+	double stl = since(start);
+	std::cout << std::setw(28) << "append " + type << std::setw(14) << loop << std::setw(14) << bulk << stl << std::endl;
+}
+
+// @brief 在中间插入一段再删掉一段，尾部每次整段搬动
+template<class T>
+static void insertErase (const std::string& type) {
+	std::vector<T> base = source<T>(BASE), chunk = source<T>(16);
+	zyz::Vector<T> v(base.begin(), base.end());
+	auto start = std::chrono::steady_clock::now();
+	for (int e = 0; e < EDITS; e ++) {
+		int pos = e * 7919 % BASE;
+		for (int i = 0; i < 16; i ++)
+			v.insert(v.begin() + pos + i, chunk[i]);
+		v.erase(v.begin() + pos, v.begin() + pos + 16);
+	}
+	double loop = since(start);
+	start = std::chrono::steady_clock::now();
+	for (int e = 0; e < EDITS; e ++) {
+		int pos = e * 7919 % BASE;
+		v.insert(v.begin() + pos, chunk.begin(), chunk.end());
+		v.erase(v.begin() + pos, v.begin() + pos + 16);
+	}
+	double bulk = since(start);
+	std::vector<T> s(base.begin(), base.end());
+	start = std::chrono::steady_clock::now();
+	for (int e = 0; e < EDITS; e ++) {
+		int pos = e * 7919 % BASE;
+		s.insert(s.begin() + pos, chunk.begin(), chunk.end());
+		s.erase(s.begin() + pos, s.begin() + pos + 16);
+	}
+	double stl = since(start);
+	std::cout << std::setw(28) << "insert+erase " + type << std::setw(14) << loop << std::setw(14) << bulk << stl << std::endl;
+}
+
+// @brief 反复整体换内容
+template<class T>
+static void assignRepeat (const std::string& type) {
+	std::vector<T> base = source<T>(BASE);
+	auto start = std::chrono::steady_clock::now();
+	zyz::Vector<T> a;
+	for (int r = 0; r < 100; r ++) {
+		a.clear();
+		for (const T& x : base)
+			a.push_back(x);
+	}
+	double loop = since(start);
+	start = std::chrono::steady_clock::now();
+	zyz::Vector<T> b;
+	for (int r = 0; r < 100; r ++)
+		b.assign(base.begin(), base.end());
+	double bulk = since(start);
+	start = std::chrono::steady_clock::now();
+	std::vector<T> s;
+	for (int r = 0; r < 100; r ++)
+		s.assign(base.begin(), base.end());
+	double stl = since(start);
+	std::cout << std::setw(28) << "assign " + type << std::setw(14) << loop << std::setw(14) << bulk << stl << std::endl;
+}
+
+// @brief 逐个操作、整段操作与 std::vector 整段操作的耗时（毫秒）
+int main () {
+	std::cout.setf(std::ios::left);
+	std::cout << std::setw(28) << "(ms)" << std::setw(14) << "zyz per-elem" << std::setw(14) << "zyz range" << "std::vector" << std::endl;
+	appendChunks<int>("int");
+	appendChunks<std::string>("string");
+	insertErase<int>("int");
+	insertErase<std::string>("string");
+	assignRepeat<int>("int");
+	assignRepeat<std::string>("string");
+}
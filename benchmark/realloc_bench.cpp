@@ -0,0 +1,84 @@
+#include "mempool.h"
+#include "allocator.h"
+#include "vector.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+
+MemPool *mem_pool = new MemPool(4, 1 << 26, TLSF_FIT);
+
+static constexpr int     ROUNDS   = 50;
+static constexpr ssize_t MIN_SIZE = 64;
+static constexpr ssize_t MAX_SIZE = 16 << 20;
+
+// @brief 从 MIN_SIZE 倍增到 MAX_SIZE：配置新块、复制、回收旧块
+static double moveGrowth () {
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < ROUNDS; r ++) {
+		auto* p = (uint8_t *)mem_pool->allocate(MIN_SIZE);
+		memset(p, r, MIN_SIZE);
+		for (ssize_t size = MIN_SIZE; size < MAX_SIZE; size <<= 1) {
+			auto* q = (uint8_t *)mem_pool->allocate(size << 1);
+			memcpy(q, p, size);
+			mem_pool->deallocate(p, size);
+			p = q;
+		}
+		mem_pool->deallocate(p, MAX_SIZE);
+	}
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+// @brief 同样的倍增，改用 reallocate，相邻空间空闲时原地扩展
+static double reallocGrowth (int &inPlace) {
+	inPlace = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < ROUNDS; r ++) {
+		auto* p = (uint8_t *)mem_pool->allocate(MIN_SIZE);
+		memset(p, r, MIN_SIZE);
+		for (ssize_t size = MIN_SIZE; size < MAX_SIZE; size <<= 1) {
+			auto* q = (uint8_t *)mem_pool->reallocate(p, size, size << 1);
+			inPlace += q == p;
+			p = q;
+		}
+		mem_pool->deallocate(p, MAX_SIZE);
+	}
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+// @brief zyz::Vector 逐个 push_back，统计缓冲区搬家的次数
+static double vectorGrowth (int &moves) {
+	moves = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < ROUNDS / 5; r ++) {
+		zyz::Vector<int> v;
+		int* last = nullptr;
+		for (int i = 0; i < (int)(MAX_SIZE / sizeof(int)); i ++) {
+			v.push_back(i);
+			if (&v[0] != last) {
+				moves ++;
+				last = &v[0];
+			}
+		}
+	}
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+int main () {
+	int inPlace, moves;
+	double moved = moveGrowth();
+	double reallocated = reallocGrowth(inPlace);
+	double vector = vectorGrowth(moves);
+	int steps = 0;
+	for (ssize_t size = MIN_SIZE; size < MAX_SIZE; size <<= 1)
+		steps ++;
+	std::cout.setf(std::ios::left);
+	std::cout << std::setw(24) << "growth 64B -> 16MB" << std::setw(12) << "ms" << "in place" << std::endl;
+	std::cout << std::setw(24) << "allocate+memcpy" << std::setw(12) << moved << 0 << " / " << steps * ROUNDS << std::endl;
+	std::cout << std::setw(24) << "reallocate" << std::setw(12) << reallocated << inPlace << " / " << steps * ROUNDS << std::endl;
+	std::cout << std::setw(24) << "zyz::Vector push_back" << std::setw(12) << vector << "buffer moves: " << moves << std::endl;
+}
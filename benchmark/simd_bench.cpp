@@ -0,0 +1,88 @@
+#include "mempool.h"
+#include "vector.h"
+#include "algorithm.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+MemPool *mem_pool = new MemPool(32, 1 << 24, TLSF_FIT);
+
+static constexpr double TOTAL_BYTES = 2e9;	///< 每一项大约扫描的总字节数
+
+static volatile long sink;
+
+// @brief 重复扫描 bytes 字节的区间直到约 TOTAL_BYTES，返回 GB/s
+static double gbps (size_t bytes, const std::function<long ()>& scan) {
+	int rounds = std::max(1, (int)(TOTAL_BYTES / (double)bytes));
+	long acc = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r ++)
+		acc += scan();
+	std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start;
+	sink = acc;
+	return (double)bytes * rounds / cost.count() / 1e9;
+}
+
+// @brief 手写的逐个比较循环
+template<class T>
+struct ScalarLoop {
+	static long find (const T* f, const T* l, T v) { for (const T* p = f; p != l; p ++) if (*p == v) return p - f; return l - f; }
+	static long count (const T* f, const T* l, T v) { long n = 0; for (; f != l; f ++) n += *f == v; return n; }
+	static long minIndex (const T* f, const T* l) { const T* m = f; for (const T* p = f; p != l; p ++) if (*p < *m) m = p; return m - f; }
+	static long maxIndex (const T* f, const T* l) { const T* m = f; for (const T* p = f; p != l; p ++) if (*m < *p) m = p; return m - f; }
+	static long sum (const T* f, const T* l) { T s = 0; for (; f != l; f ++) s += *f; return (long)s; }
+};
+
+// @brief 一种元素类型、一种大小下各操作的吞吐：手写循环与各级别内核
+template<class T>
+static void suite (const std::string& type, int n) {
+	zyz::Vector<T> v;
+	for (int i = 0; i < n; i ++)
+		v.push_back((T)(i % 1000 + 1));
+	const T* f = &v[0];
+	const T* l = f + n;
+	size_t bytes = sizeof(T) * n;
+	T absent = (T)-1;
+	using Loop = ScalarLoop<T>;
+	std::pair<std::string, std::function<long ()>> loops[] = {
+		{"find", [&] { return Loop::find(f, l, absent); }},
+		{"count", [&] { return Loop::count(f, l, (T)7); }},
+		{"min_element", [&] { return Loop::minIndex(f, l); }},
+		{"max_element", [&] { return Loop::maxIndex(f, l); }},
+		{"sum", [&] { return Loop::sum(f, l); }},
+	};
+	std::pair<std::string, std::function<long ()>> kernels[] = {
+		{"find", [&] { return (long)(zyz::find(v, absent) - v.begin()); }},
+		{"count", [&] { return (long)zyz::count(v, (T)7); }},
+		{"min_element", [&] { return (long)(zyz::min_element(v) - v.begin()); }},
+		{"max_element", [&] { return (long)(zyz::max_element(v) - v.begin()); }},
+		{"sum", [&] { return (long)zyz::sum(v); }},
+	};
+	for (int i = 0; i < 5; i ++) {
+		std::cout << std::setw(32) << type + " " + loops[i].first + " " + std::to_string(bytes >> 10) + "KB"
+			<< std::setw(12) << gbps(bytes, loops[i].second);
+		for (int level : {zyz::simd::LEVEL_SCALAR, zyz::simd::LEVEL_SSE42, zyz::simd::LEVEL_AVX2}) {
+			if (zyz::simd::setLevel(level) == level)
+				std::cout << std::setw(12) << gbps(bytes, kernels[i].second);
+			else
+				std::cout << std::setw(12) << "-";
+		}
+		std::cout << std::endl;
+		zyz::simd::setLevel(zyz::simd::LEVEL_AVX2);
+	}
+}
+
+// @brief 缓存内（64K 个元素）与内存中（16M 个元素）两种大小下的 GB/s
+int main () {
+	std::cout.setf(std::ios::left);
+	std::cout << "detected level: " << zyz::simd::detectLevel() << " (0 scalar, 1 sse4.2, 2 avx2)" << std::endl;
+	std::cout << std::setw(32) << "(GB/s)" << std::setw(12) << "loop" << std::setw(12) << "scalar"
+		<< std::setw(12) << "sse4.2" << std::setw(12) << "avx2" << std::endl;
+	for (int n : {1 << 16, 1 << 24}) {
+		suite<int>("int", n);
+		suite<float>("float", n);
+	}
+}
@@ -0,0 +1,67 @@
+#include "mempool.h"
+#include "smallvector.h"
+#include "stack.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+MemPool *mem_pool = new MemPool(32, 1 << 20, TLSF_FIT);
+
+static constexpr int ROUNDS = 1000000;
+
+static double since (std::chrono::steady_clock::time_point start) {
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+// @brief 大量只装几个元素的短命数组：每轮装 1~8 个
+template<class Vec>
+static double shortLived () {
+	long sum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < ROUNDS; r ++) {
+		Vec v;
+		for (int i = 0; i <= r % 8; i ++)
+			v.push_back(i);
+		sum += v.back();
+	}
+	double cost = since(start);
+	if (sum < 0)
+		std::cout << sum;
+	return cost;
+}
+
+// @brief 浅栈：每轮压入 弹出 不超过 12 层
+template<class S>
+static double shallowStack () {
+	long sum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < ROUNDS; r ++) {
+		S s;
+		for (int i = 0; i < 4 + r % 8; i ++)
+			s.push(i);
+		while (s.size()) {
+			sum += s.top();
+			s.pop();
+		}
+	}
+	double cost = since(start);
+	if (sum < 0)
+		std::cout << sum;
+	return cost;
+}
+
+// @brief 对比 Vector / SmallVector / std::vector 装少量元素与用作栈的底层容器
+int main () {
+	std::cout.setf(std::ios::left);
+	std::cout << std::setw(44) << "(ms)" << ROUNDS << " rounds" << std::endl;
+	std::cout << std::setw(44) << "zyz::Vector<int>" << shortLived<zyz::Vector<int>>() << std::endl;
+	std::cout << std::setw(44) << "zyz::SmallVector<int, 8>" << shortLived<zyz::SmallVector<int, 8>>() << std::endl;
+	std::cout << std::setw(44) << "std::vector<int>" << shortLived<std::vector<int>>() << std::endl;
+	std::cout << std::setw(44) << "zyz::Stack<int>" << shallowStack<zyz::Stack<int>>() << std::endl;
+	std::cout << std::setw(44) << "zyz::Stack<int, .., SmallVector<int, 16>>"
+		<< shallowStack<zyz::Stack<int, zyz::Allocator<int>, zyz::SmallVector<int, 16>>>() << std::endl;
+}
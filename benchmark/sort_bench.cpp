@@ -0,0 +1,70 @@
+#include "mempool.h"
+#include "vector.h"
+#include "algorithm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+
+MemPool *mem_pool = new MemPool(32, 1 << 24, TLSF_FIT);
+
+static constexpr int N = 1000000;
+
+static double since (std::chrono::steady_clock::time_point start) {
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+// @brief 各种输入模式
+static zyz::Vector<int> pattern (const std::string& name, int n) {
+	std::mt19937 rng(42);
+	zyz::Vector<int> v;
+	v.reserve(n);
+	for (int i = 0; i < n; i ++) {
+		if (name == "random")
+			v.push_back((int)rng());
+		else if (name == "sorted")
+			v.push_back(i);
+		else if (name == "reversed")
+			v.push_back(n - i);
+		else if (name == "organ-pipe")
+			v.push_back(i < n / 2 ? i : n - i);
+		else if (name == "few-unique")
+			v.push_back((int)(rng() % 16));
+		else if (name == "sorted+noise")
+			v.push_back(i % 1000 == 0 ? (int)rng() : i);
+	}
+	return v;
+}
+
+template<class Vec, class Sort>
+static double timeSort (const Vec& input, Sort sort) {
+	Vec v(input);
+	auto start = std::chrono::steady_clock::now();
+	sort(v);
+	double cost = since(start);
+	if (!std::is_sorted(v.begin(), v.end()))
+		std::cout << "NOT SORTED ";
+	return cost;
+}
+
+// @brief zyz::sort 与 std::sort 在各种输入上的耗时（毫秒）
+int main () {
+	std::cout.setf(std::ios::left);
+	std::cout << std::setw(24) << "(ms) " + std::to_string(N) << std::setw(14) << "zyz::sort" << "std::sort" << std::endl;
+	for (std::string name : {"random", "sorted", "reversed", "organ-pipe", "few-unique", "sorted+noise"}) {
+		zyz::Vector<int> input = pattern(name, N);
+		std::cout << std::setw(24) << "int " + name
+			<< std::setw(14) << timeSort(input, [] (zyz::Vector<int>& v) { zyz::sort(v.begin(), v.end()); })
+			<< timeSort(input, [] (zyz::Vector<int>& v) { std::sort(v.begin(), v.end()); }) << std::endl;
+	}
+	zyz::Vector<std::string> strings;
+	for (int x : pattern("random", N / 4))
+		strings.push_back(std::to_string(x));
+	std::cout << std::setw(24) << "string random"
+		<< std::setw(14) << timeSort(strings, [] (zyz::Vector<std::string>& v) { zyz::sort(v.begin(), v.end()); })
+		<< timeSort(strings, [] (zyz::Vector<std::string>& v) { std::sort(v.begin(), v.end()); }) << std::endl;
+}
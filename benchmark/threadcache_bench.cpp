@@ -0,0 +1,65 @@
+#include "mempool.h"
+#include "allocator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+MemPool *mem_pool = new MemPool(2000, 4800, FIRST_FIT);
+
+static constexpr int ROUNDS = 20000;
+static constexpr int BURST  = 16;
+
+// @brief 经过线程本地缓存：zyz::Allocator 的 配置/回收
+static void cachedWork () {
+	zyz::Allocator<int> alloc;
+	int* blocks[BURST];
+	for (int r = 0; r < ROUNDS; r ++) {
+		for (int i = 0; i < BURST; i ++)
+			blocks[i] = alloc.allocate(1 + i % 8);
+		for (int i = 0; i < BURST; i ++)
+			alloc.deallocate(blocks[i], 1 + i % 8);
+	}
+}
+
+// @brief 直接走内存池：每次都要拿全局锁
+static void lockedWork () {
+	uint8_t* blocks[BURST];
+	for (int r = 0; r < ROUNDS; r ++) {
+		for (int i = 0; i < BURST; i ++)
+			blocks[i] = (uint8_t *)mem_pool->allocate(ThreadCache::classSize((1 + i % 8) * sizeof(int)));
+		for (int i = 0; i < BURST; i ++)
+			mem_pool->deallocate(blocks[i], ThreadCache::classSize((1 + i % 8) * sizeof(int)));
+	}
+}
+
+// @brief 用 nThreads 个线程跑 work，返回每秒 配置+回收 次数（百万）
+static double run (int nThreads, void (*work)()) {
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	for (int i = 0; i < nThreads; i ++)
+		threads.emplace_back(work);
+	for (auto& t : threads)
+		t.join();
+	std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start;
+	return (double)nThreads * ROUNDS * BURST / cost.count() / 1e6;
+}
+
+int main (int argc, char** argv) {
+	int maxThreads = argc > 1 ? std::atoi(argv[1]) : (int)std::thread::hardware_concurrency();
+	if (maxThreads < 1)
+		maxThreads = 1;
+	std::cout.setf(std::ios::left);
+	std::cout << std::setw(10) << "threads" << std::setw(20) << "locked(Mops/s)" << std::setw(20) << "cached(Mops/s)" << std::endl;
+	for (int n = 1; ; n = std::min(n * 2, maxThreads)) {
+		double locked = run(n, lockedWork);
+		double cached = run(n, cachedWork);
+		std::cout << std::setw(10) << n << std::setw(20) << locked << std::setw(20) << cached << std::endl;
+		if (n == maxThreads)
+			break;
+	}
+}
@@ -0,0 +1,93 @@
+#include "mempool.h"
+#include "vector.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+MemPool *mem_pool = new MemPool(32, 1 << 24, TLSF_FIT);
+
+static constexpr int ELEMENTS = 200000;
+static constexpr int ROWS     = 20000;
+static constexpr int ROW_SIZE = 16;
+
+// @brief 统计 复制/移动 次数的元素类型
+struct Counted {
+	static inline long copies = 0;
+	static inline long moves = 0;
+
+	Counted() = default;
+	explicit Counted(int _v) : v(_v) {}
+	Counted(const Counted& that) : v(that.v) { copies ++; }
+	Counted(Counted&& that) noexcept : v(that.v) { moves ++; }
+	Counted& operator=(const Counted& that) { v = that.v; copies ++; return *this; }
+	Counted& operator=(Counted&& that) noexcept { v = that.v; moves ++; return *this; }
+
+	static void reset() { copies = moves = 0; }
+
+	int v = 0;
+};
+
+static double since (std::chrono::steady_clock::time_point start) {
+	std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+	return cost.count();
+}
+
+static void report (const std::string& name, double ms) {
+	std::cout << std::setw(36) << name << std::setw(12) << ms << std::setw(12) << Counted::copies << Counted::moves << std::endl;
+}
+
+// @brief 逐个 push_back 右值，扩容时旧元素要搬家
+template<class Vec>
+static void pushRvalues (const std::string& name) {
+	Counted::reset();
+	auto start = std::chrono::steady_clock::now();
+	Vec v;
+	for (int i = 0; i < ELEMENTS; i ++)
+		v.push_back(Counted(i));
+	report(name, since(start));
+}
+
+// @brief 逐行 push_back 临时的内层数组：内层数组本身应被移动，元素一个都不该被复制
+template<class Outer, class Inner>
+static void pushRows (const std::string& name) {
+	Counted::reset();
+	auto start = std::chrono::steady_clock::now();
+	Outer rows;
+	for (int r = 0; r < ROWS; r ++) {
+		Inner row;
+		for (int i = 0; i < ROW_SIZE; i ++)
+			row.emplace_back(i);
+		rows.push_back(std::move(row));
+	}
+	Outer moved;
+	moved = std::move(rows);
+	report(name, since(start));
+}
+
+// @brief 字符串数组：扩容时搬家的是 std::string 对象本身，长字符串不应重新配置
+template<class Vec>
+static void pushStrings (const std::string& name) {
+	Counted::reset();
+	std::string text(48, 'x');
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < 10; r ++) {
+		Vec v;
+		for (int i = 0; i < ELEMENTS / 10; i ++)
+			v.push_back(text);
+	}
+	report(name, since(start));
+}
+
+int main () {
+	std::cout.setf(std::ios::left);
+	std::cout << std::setw(36) << "" << std::setw(12) << "ms" << std::setw(12) << "copies" << "moves" << std::endl;
+	pushRvalues<zyz::Vector<Counted>>("zyz::Vector<Counted>");
+	pushRvalues<std::vector<Counted>>("std::vector<Counted>");
+	pushRows<zyz::Vector<zyz::Vector<Counted>>, zyz::Vector<Counted>>("zyz::Vector<zyz::Vector<Counted>>");
+	pushRows<std::vector<std::vector<Counted>>, std::vector<Counted>>("std::vector<std::vector<Counted>>");
+	pushStrings<zyz::Vector<std::string>>("zyz::Vector<std::string>");
+	pushStrings<std::vector<std::string>>("std::vector<std::string>");
+}
@@ -1,6 +1,24 @@
 #ifndef MEM_MANAGE_ALGORITHM_H
 #define MEM_MANAGE_ALGORITHM_H
 
+#include "simd.h"
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace zyz {
 
 	template<class T> struct less {
@@ -22,97 +40,1036 @@ namespace zyz {
 	};
 
 	template<class T>
-	_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
+	[[nodiscard]] inline
 	const T& max (const T& a, const T& b) {
 		return a > b ? a : b;
 	}
 
 	template<class T, typename compare>
-	_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
+	[[nodiscard]] inline
 	const T& max (const T& a, const T& b, compare comp = less<T>()) {
 		return comp(a, b) ? b : a;
 	}
 
 	template<class T>
-	_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
+	[[nodiscard]] inline
 	const T& min (const T& a, const T& b) {
 		return a < b ? a : b;
 	}
 
 	template<class T, typename compare>
-	_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
+	[[nodiscard]] inline
 	const T& min (const T& a, const T& b, compare comp) {
 		return comp(a, b) ? a : b;
 	}
 
 	template<class T>
-	inline _LIBCPP_INLINE_VISIBILITY
+	inline
 	void swap(T& x, T& y) {
-		T _t(std::_LIBCPP_ABI_NAMESPACE::move(x));
-		x = std::_LIBCPP_ABI_NAMESPACE::move(y);
-		y = std::_LIBCPP_ABI_NAMESPACE::move(_t);
+		T _t(std::move(x));
+		x = std::move(y);
+		y = std::move(_t);
 	}
 
+	// 连续存放的 int32_t / float 区间交给 simd.h 的向量化内核，别的区间按顺序逐个比较
+	template<class Iterator>
+	concept __simd_range = std::contiguous_iterator<Iterator>
+	                       && (std::is_same_v<std::iter_value_t<Iterator>, int32_t> || std::is_same_v<std::iter_value_t<Iterator>, float>);
+
+	// 有 begin()/end() 的容器（如 zyz::Vector）
+	template<class Container>
+	concept __iterable = requires (const Container& c) { c.begin(); c.end(); };
+
+	/**
+	 * @brief 第一个等于 value 的位置，没有为 last
+	 */
+	template<class InputIterator, class T>
+	InputIterator find (InputIterator first, InputIterator last, const T& value) {
+		if constexpr (__simd_range<InputIterator> && std::is_same_v<std::iter_value_t<InputIterator>, T>) {
+			if (first == last)
+				return last;
+			auto p = std::to_address(first);
+			return first + (simd::find(p, p + (last - first), value) - p);
+		} else {
+			for (; first != last; ++first)
+				if (*first == value)
+					return first;
+			return last;
+		}
+	}
+
+	/**
+	 * @brief 等于 value 的元素个数
+	 */
+	template<class InputIterator, class T>
+	ptrdiff_t count (InputIterator first, InputIterator last, const T& value) {
+		if constexpr (__simd_range<InputIterator> && std::is_same_v<std::iter_value_t<InputIterator>, T>) {
+			if (first == last)
+				return 0;
+			auto p = std::to_address(first);
+			return simd::count(p, p + (last - first), value);
+		} else {
+			ptrdiff_t ret = 0;
+			for (; first != last; ++first)
+				ret += *first == value;
+			return ret;
+		}
+	}
+
+	/**
+	 * @brief 区间中是否有等于 value 的元素
+	 */
+	template<class InputIterator, class T>
+	bool contains (InputIterator first, InputIterator last, const T& value) {
+		return zyz::find(first, last, value) != last;
+	}
+
+	/**
+	 * @brief 第一个最小元素的位置，空区间为 last
+	 * @details 向量化时先求出最小值再找它第一次出现的位置，结果与逐个比较相同：
+	 *          float 区间的第一个元素是 NaN 时返回它，否则 NaN 都不会被选中；万一找不到求出的值就退回逐个比较
+	 */
 	template<class ForwardIterator>
-	ForwardIterator __quicksort_paritition (ForwardIterator begin, ForwardIterator end) {
-		decltype(*begin) pivot = *begin;
-		ForwardIterator l = begin, r = end;
-		while (l < r) {
-			while (l < r && *r >= pivot)
-				--r;
-			while (l < r && *l <= pivot)
-				++l;
-			if (l < r) {
-				swap(*l, *r);
-			}
+	ForwardIterator min_element (ForwardIterator first, ForwardIterator last) {
+		if (first == last)
+			return last;
+		if constexpr (__simd_range<ForwardIterator>) {
+			// 第一个元素是 NaN 时和谁比较都为假，逐个比较也不会换掉它
+			if (*first != *first)
+				return first;
+			auto p = std::to_address(first);
+			ForwardIterator ret = zyz::find(first, last, simd::minValue(p, p + (last - first)));
+			if (ret != last)
+				return ret;
+		}
+		ForwardIterator ret = first;
+		for (++first; first != last; ++first)
+			if (*first < *ret)
+				ret = first;
+		return ret;
+	}
+
+	template<class ForwardIterator, typename Func>
+	ForwardIterator min_element (ForwardIterator first, ForwardIterator last, Func comp) {
+		if (first == last)
+			return last;
+		ForwardIterator ret = first;
+		for (++first; first != last; ++first)
+			if (comp(*first, *ret))
+				ret = first;
+		return ret;
+	}
+
+	/**
+	 * @brief 第一个最大元素的位置，空区间为 last
+	 * @details 向量化时先求出最大值再找它第一次出现的位置，结果与逐个比较相同：
+	 *          float 区间的第一个元素是 NaN 时返回它，否则 NaN 都不会被选中；万一找不到求出的值就退回逐个比较
+	 */
+	template<class ForwardIterator>
+	ForwardIterator max_element (ForwardIterator first, ForwardIterator last) {
+		if (first == last)
+			return last;
+		if constexpr (__simd_range<ForwardIterator>) {
+			// 第一个元素是 NaN 时和谁比较都为假，逐个比较也不会换掉它
+			if (*first != *first)
+				return first;
+			auto p = std::to_address(first);
+			ForwardIterator ret = zyz::find(first, last, simd::maxValue(p, p + (last - first)));
+			if (ret != last)
+				return ret;
 		}
-		swap(*begin, *l);
-		return l;
+		ForwardIterator ret = first;
+		for (++first; first != last; ++first)
+			if (*ret < *first)
+				ret = first;
+		return ret;
 	}
 
 	template<class ForwardIterator, typename Func>
-	ForwardIterator __quicksort_paritition (ForwardIterator begin, ForwardIterator end, Func comp) {
-		decltype(*begin) pivot = *begin;
-		ForwardIterator l = begin, r = end;
-		while (l < r) {
-			while (l < r && !comp(*r, pivot))
-				--r;
-			while (l < r && !comp(pivot, *l))
-				++l;
-			if (l < r) {
-				swap(*l, *r);
+	ForwardIterator max_element (ForwardIterator first, ForwardIterator last, Func comp) {
+		if (first == last)
+			return last;
+		ForwardIterator ret = first;
+		for (++first; first != last; ++first)
+			if (comp(*ret, *first))
+				ret = first;
+		return ret;
+	}
+
+	/**
+	 * @brief init 加上区间所有元素，返回类型与 init 相同
+	 * @details 与 std::reduce 相同，加法的结合顺序不固定（float 的舍入可能与顺序累加不同）
+	 *          int32_t 区间先用 64 位求和再加到 init 上，init 为 int 时结果等同于按 int 回绕
+	 */
+	template<class InputIterator, class T>
+	T reduce (InputIterator first, InputIterator last, T init) {
+		if constexpr (__simd_range<InputIterator>) {
+			if (first == last)
+				return init;
+			auto p = std::to_address(first);
+			return (T)(init + simd::sum(p, p + (last - first)));
+		} else {
+			for (; first != last; ++first)
+				init = init + *first;
+			return init;
+		}
+	}
+
+	/**
+	 * @brief 区间所有元素之和，int32_t 区间返回 64 位的和
+	 */
+	template<class InputIterator>
+	auto sum (InputIterator first, InputIterator last) {
+		using T = std::iter_value_t<InputIterator>;
+		if constexpr (std::is_same_v<T, int32_t>)
+			return zyz::reduce(first, last, (int64_t)0);
+		else
+			return zyz::reduce(first, last, T());
+	}
+
+	template<__iterable Container, class T>
+	auto find (const Container& c, const T& value) {
+		return zyz::find(c.begin(), c.end(), value);
+	}
+
+	template<__iterable Container, class T>
+	ptrdiff_t count (const Container& c, const T& value) {
+		return zyz::count(c.begin(), c.end(), value);
+	}
+
+	template<__iterable Container, class T>
+	bool contains (const Container& c, const T& value) {
+		return zyz::contains(c.begin(), c.end(), value);
+	}
+
+	template<__iterable Container>
+	auto min_element (const Container& c) {
+		return zyz::min_element(c.begin(), c.end());
+	}
+
+	template<__iterable Container>
+	auto max_element (const Container& c) {
+		return zyz::max_element(c.begin(), c.end());
+	}
+
+	template<__iterable Container, class T>
+	T reduce (const Container& c, T init) {
+		return zyz::reduce(c.begin(), c.end(), init);
+	}
+
+	template<__iterable Container>
+	auto sum (const Container& c) {
+		return zyz::sum(c.begin(), c.end());
+	}
+
+	// pattern-defeating quicksort（Orson Peters）的参数
+	constexpr ptrdiff_t __sort_insertion_threshold = 24;	///< 小于它的区间直接插入排序
+	constexpr ptrdiff_t __sort_ninther_threshold   = 128;	///< 大于它的区间用九数取中选基准
+	constexpr ptrdiff_t __sort_partial_limit       = 8;		///< 试探性插入排序最多移动的次数
+	constexpr ptrdiff_t __sort_block_size          = 64;	///< 无分支分区一块的元素数
+
+	// 元素为算术类型、比较就是 < 或 > 时比较结果可以当作数值用，分区走无分支的块分区
+	template<class T, class Func>
+	constexpr bool __branchless_compare = std::is_arithmetic_v<T>
+		&& (std::is_same_v<Func, less<T>> || std::is_same_v<Func, greater<T>>
+		    || std::is_same_v<Func, std::less<T>> || std::is_same_v<Func, std::greater<T>>
+		    || std::is_same_v<Func, std::less<>> || std::is_same_v<Func, std::greater<>>);
+
+	template<class RandomIterator>
+	inline void __iter_swap (RandomIterator a, RandomIterator b) {
+		zyz::swap(*a, *b);
+	}
+
+	// @brief 插入排序；unguarded 时 begin 前面必须有一个不大于区间内所有元素的元素，内层循环不用检查边界
+	template<bool unguarded, class RandomIterator, typename Func>
+	void __insertion_sort (RandomIterator begin, RandomIterator end, Func comp) {
+		using T = std::iter_value_t<RandomIterator>;
+		if (begin == end)
+			return;
+		for (RandomIterator cur = begin + 1; cur != end; ++cur) {
+			RandomIterator sift = cur, sift_1 = cur - 1;
+			if (comp(*sift, *sift_1)) {
+				T tmp(std::move(*sift));
+				do {
+					*sift-- = std::move(*sift_1);
+				} while ((unguarded || sift != begin) && comp(tmp, *--sift_1));
+				*sift = std::move(tmp);
 			}
 		}
-		swap(*begin, *l);
-		return l;
 	}
 
-	template<class ForwardIterator>
-	void __quicksort (ForwardIterator begin, ForwardIterator end) {
-		if (begin >= end || begin >= end - 1)
+	// @brief 试探性插入排序：移动超过 __sort_partial_limit 次就放弃，返回是否排好
+	template<class RandomIterator, typename Func>
+	bool __partial_insertion_sort (RandomIterator begin, RandomIterator end, Func comp) {
+		using T = std::iter_value_t<RandomIterator>;
+		if (begin == end)
+			return true;
+		ptrdiff_t moved = 0;
+		for (RandomIterator cur = begin + 1; cur != end; ++cur) {
+			RandomIterator sift = cur, sift_1 = cur - 1;
+			if (comp(*sift, *sift_1)) {
+				T tmp(std::move(*sift));
+				do {
+					*sift-- = std::move(*sift_1);
+				} while (sift != begin && comp(tmp, *--sift_1));
+				*sift = std::move(tmp);
+				moved += cur - sift;
+			}
+			if (moved > __sort_partial_limit)
+				return false;
+		}
+		return true;
+	}
+
+	template<class RandomIterator, typename Func>
+	inline void __sort2 (RandomIterator a, RandomIterator b, Func comp) {
+		if (comp(*b, *a))
+			__iter_swap(a, b);
+	}
+
+	// @brief 三个位置排好序，中位数落在 b
+	template<class RandomIterator, typename Func>
+	inline void __sort3 (RandomIterator a, RandomIterator b, RandomIterator c, Func comp) {
+		__sort2(a, b, comp);
+		__sort2(b, c, comp);
+		__sort2(a, b, comp);
+	}
+
+	template<class RandomIterator, typename Func>
+	void __sift_down (RandomIterator begin, ptrdiff_t n, ptrdiff_t i, Func comp) {
+		using T = std::iter_value_t<RandomIterator>;
+		T value(std::move(begin[i]));
+		while (true) {
+			ptrdiff_t child = 2 * i + 1;
+			if (child >= n)
+				break;
+			if (child + 1 < n && comp(begin[child], begin[child + 1]))
+				child ++;
+			if (!comp(value, begin[child]))
+				break;
+			begin[i] = std::move(begin[child]);
+			i = child;
+		}
+		begin[i] = std::move(value);
+	}
+
+	// @brief 堆排序：分区连续太不均衡时的兜底，保证 O(n log n)
+	template<class RandomIterator, typename Func>
+	void __heapsort (RandomIterator begin, RandomIterator end, Func comp) {
+		ptrdiff_t n = end - begin;
+		for (ptrdiff_t i = n / 2 - 1; i >= 0; i --)
+			__sift_down(begin, n, i, comp);
+		for (ptrdiff_t k = n - 1; k > 0; k --) {
+			__iter_swap(begin, begin + k);
+			__sift_down(begin, k, 0, comp);
+		}
+	}
+
+	/**
+	 * @brief 以 *begin 为基准分区：小于基准的在左，不小于的在右
+	 * @return 基准的最终位置，以及分区前是否本来就分好了
+	 */
+	template<class RandomIterator, typename Func>
+	std::pair<RandomIterator, bool> __partition_right (RandomIterator begin, RandomIterator end, Func comp) {
+		using T = std::iter_value_t<RandomIterator>;
+		T pivot(std::move(*begin));
+		RandomIterator first = begin, last = end;
+		// 基准是三数中值，左边一定能停下；右边只有第一个元素就停时才需要检查边界
+		while (comp(*++first, pivot));
+		if (first - 1 == begin)
+			while (first < last && !comp(*--last, pivot));
+		else
+			while (!comp(*--last, pivot));
+		bool already = first >= last;
+		while (first < last) {
+			__iter_swap(first, last);
+			while (comp(*++first, pivot));
+			while (!comp(*--last, pivot));
+		}
+		RandomIterator pivotPos = first - 1;
+		*begin = std::move(*pivotPos);
+		*pivotPos = std::move(pivot);
+		return {pivotPos, already};
+	}
+
+	// @brief 按两张偏移表交换 num 对放错边的元素；两边个数不同时用环形移动代替交换
+	template<class RandomIterator>
+	void __swap_offsets (RandomIterator first, RandomIterator last, const unsigned char* offsetsL,
+	                     const unsigned char* offsetsR, ptrdiff_t num, bool useSwaps) {
+		using T = std::iter_value_t<RandomIterator>;
+		if (useSwaps) {
+			for (ptrdiff_t i = 0; i < num; i ++)
+				__iter_swap(first + offsetsL[i], last - offsetsR[i]);
+		} else if (num > 0) {
+			RandomIterator l = first + offsetsL[0], r = last - offsetsR[0];
+			T tmp(std::move(*l));
+			*l = std::move(*r);
+			for (ptrdiff_t i = 1; i < num; i ++) {
+				l = first + offsetsL[i];
+				*r = std::move(*l);
+				r = last - offsetsR[i];
+				*l = std::move(*r);
+			}
+			*r = std::move(tmp);
+		}
+	}
+
+	/**
+	 * @brief 无分支的块分区（BlockQuicksort）：结果与 __partition_right 相同
+	 * @details 左右各取一块，比较结果直接累加到偏移表的下标上记下放错边的元素，循环里没有依赖比较结果的分支
+	 *          再按偏移表成对交换，避免随机数据上的分支预测失败
+	 */
+	template<class RandomIterator, typename Func>
+	std::pair<RandomIterator, bool> __partition_right_branchless (RandomIterator begin, RandomIterator end, Func comp) {
+		using T = std::iter_value_t<RandomIterator>;
+		T pivot(std::move(*begin));
+		RandomIterator first = begin, last = end;
+		while (comp(*++first, pivot));
+		if (first - 1 == begin)
+			while (first < last && !comp(*--last, pivot));
+		else
+			while (!comp(*--last, pivot));
+		bool already = first >= last;
+		if (!already) {
+			__iter_swap(first, last);
+			++first;
+			alignas(64) unsigned char offsetsL[__sort_block_size];
+			alignas(64) unsigned char offsetsR[__sort_block_size];
+			RandomIterator baseL = first, baseR = last;
+			ptrdiff_t numL = 0, numR = 0, startL = 0, startR = 0;
+			while (first < last) {
+				// 只给空了的表补一块，剩下不足两块时两边平分
+				ptrdiff_t unknown = last - first;
+				ptrdiff_t splitL = numL == 0 ? (numR == 0 ? unknown / 2 : unknown) : 0;
+				ptrdiff_t splitR = numR == 0 ? unknown - splitL : 0;
+				splitL = std::min(splitL, __sort_block_size);
+				splitR = std::min(splitR, __sort_block_size);
+				for (ptrdiff_t i = 0; i < splitL; i ++) {
+					offsetsL[numL] = (unsigned char)i;
+					numL += !comp(*first, pivot);
+					++first;
+				}
+				for (ptrdiff_t i = 0; i < splitR; ) {
+					offsetsR[numR] = (unsigned char)++i;
+					numR += comp(*--last, pivot);
+				}
+				ptrdiff_t num = std::min(numL, numR);
+				__swap_offsets(baseL, baseR, offsetsL + startL, offsetsR + startR, num, numL == numR);
+				numL -= num;
+				numR -= num;
+				startL += num;
+				startR += num;
+				if (numL == 0) {
+					startL = 0;
+					baseL = first;
+				}
+				if (numR == 0) {
+					startR = 0;
+					baseR = last;
+				}
+			}
+			// 一边的表还有剩余：把这些元素依次换到分界处
+			if (numL) {
+				while (numL --)
+					__iter_swap(baseL + offsetsL[startL + numL], --last);
+				first = last;
+			}
+			if (numR) {
+				while (numR --) {
+					__iter_swap(baseR - offsetsR[startR + numR], first);
+					++first;
+				}
+				last = first;
+			}
+		}
+		RandomIterator pivotPos = first - 1;
+		*begin = std::move(*pivotPos);
+		*pivotPos = std::move(pivot);
+		return {pivotPos, already};
+	}
+
+	/**
+	 * @brief 以 *begin 为基准分区：不大于基准的在左，大于的在右，返回基准的最终位置
+	 * @details 用于基准与左侧相邻元素相等时：等于基准的元素一次全部归位，大量重复元素时线性
+	 */
+	template<class RandomIterator, typename Func>
+	RandomIterator __partition_left (RandomIterator begin, RandomIterator end, Func comp) {
+		using T = std::iter_value_t<RandomIterator>;
+		T pivot(std::move(*begin));
+		RandomIterator first = begin, last = end;
+		while (comp(pivot, *--last));
+		if (last + 1 == end)
+			while (first < last && !comp(pivot, *++first));
+		else
+			while (!comp(pivot, *++first));
+		while (first < last) {
+			__iter_swap(first, last);
+			while (comp(pivot, *--last));
+			while (!comp(pivot, *++first));
+		}
+		RandomIterator pivotPos = last;
+		*begin = std::move(*pivotPos);
+		*pivotPos = std::move(pivot);
+		return pivotPos;
+	}
+
+	/**
+	 * @brief pdqsort 主循环
+	 * @param badAllowed 还允许多少次很不均衡的分区，用完改用堆排序
+	 * @param leftmost   区间是否在最左侧（不是时 begin 前一个元素不大于区间内所有元素）
+	 *
+	 * @details 递归较短的一侧、循环处理较长的一侧，栈深度 O(log n)
+	 */
+	template<bool branchless, class RandomIterator, typename Func>
+	void __pdqsort_loop (RandomIterator begin, RandomIterator end, Func comp, int badAllowed, bool leftmost) {
+		while (true) {
+			ptrdiff_t size = end - begin;
+			if (size < __sort_insertion_threshold) {
+				if (leftmost)
+					__insertion_sort<false>(begin, end, comp);
+				else
+					__insertion_sort<true>(begin, end, comp);
+				return;
+			}
+
+			// 选基准放到 begin：大区间九数取中，小区间三数取中
+			ptrdiff_t half = size / 2;
+			if (size > __sort_ninther_threshold) {
+				__sort3(begin, begin + half, end - 1, comp);
+				__sort3(begin + 1, begin + (half - 1), end - 2, comp);
+				__sort3(begin + 2, begin + (half + 1), end - 3, comp);
+				__sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+				__iter_swap(begin, begin + half);
+			} else {
+				__sort3(begin + half, begin, end - 1, comp);
+			}
+
+			// 基准等于左侧相邻元素：区间里和它相等的都该排在最左，一次分完只处理右边
+			if (!leftmost && !comp(*(begin - 1), *begin)) {
+				begin = __partition_left(begin, end, comp) + 1;
+				continue;
+			}
+
+			auto [pivotPos, already] = branchless ? __partition_right_branchless(begin, end, comp)
+			                                      : __partition_right(begin, end, comp);
+			ptrdiff_t sizeL = pivotPos - begin;
+			ptrdiff_t sizeR = end - (pivotPos + 1);
+
+			if (sizeL < size / 8 || sizeR < size / 8) {
+				// 很不均衡：次数用完就堆排序，否则打乱两侧的几个元素破坏可能的输入模式
+				if (-- badAllowed == 0) {
+					__heapsort(begin, end, comp);
+					return;
+				}
+				if (sizeL >= __sort_insertion_threshold) {
+					__iter_swap(begin, begin + sizeL / 4);
+					__iter_swap(pivotPos - 1, pivotPos - sizeL / 4);
+					if (sizeL > __sort_ninther_threshold) {
+						__iter_swap(begin + 1, begin + (sizeL / 4 + 1));
+						__iter_swap(begin + 2, begin + (sizeL / 4 + 2));
+						__iter_swap(pivotPos - 2, pivotPos - (sizeL / 4 + 1));
+						__iter_swap(pivotPos - 3, pivotPos - (sizeL / 4 + 2));
+					}
+				}
+				if (sizeR >= __sort_insertion_threshold) {
+					__iter_swap(pivotPos + 1, pivotPos + (1 + sizeR / 4));
+					__iter_swap(end - 1, end - sizeR / 4);
+					if (sizeR > __sort_ninther_threshold) {
+						__iter_swap(pivotPos + 2, pivotPos + (2 + sizeR / 4));
+						__iter_swap(pivotPos + 3, pivotPos + (3 + sizeR / 4));
+						__iter_swap(end - 2, end - (1 + sizeR / 4));
+						__iter_swap(end - 3, end - (2 + sizeR / 4));
+					}
+				}
+			} else if (already && __partial_insertion_sort(begin, pivotPos, comp)
+			           && __partial_insertion_sort(pivotPos + 1, end, comp)) {
+				// 分区前就分好了且两侧都近乎有序：试探性插入排序直接完成
+				return;
+			}
+
+			if (sizeL < sizeR) {
+				__pdqsort_loop<branchless>(begin, pivotPos, comp, badAllowed, leftmost);
+				begin = pivotPos + 1;
+				leftmost = false;
+			} else {
+				__pdqsort_loop<branchless>(pivotPos + 1, end, comp, badAllowed, false);
+				end = pivotPos;
+			}
+		}
+	}
+
+	// @brief floor(log2(n))
+	inline int __log2 (ptrdiff_t n) {
+		int ret = 0;
+		while (n >>= 1)
+			ret ++;
+		return ret;
+	}
+
+	// 短于这个长度的区间 zyz::sort 不改用基数排序，额外缓冲区和直方图不划算；键越宽趟数越多，阈值越高
+	template<class T>
+	inline constexpr ptrdiff_t __radix_sort_threshold = 512 * (ptrdiff_t)sizeof(T);
+	// MSD 字符串排序中短于这个长度的桶直接插入排序
+	inline constexpr ptrdiff_t __radix_msd_insertion_threshold = 32;
+	// 基数排序一趟处理的位数上限，16 位时直方图已有 65536 个桶
+	inline constexpr int __radix_max_bits = 16;
+
+	// 能按位分配的算术键：整数、bool 以及 IEEE 754 的 float / double
+	template<class K>
+	concept __radix_arithmetic_key = std::is_arithmetic_v<K> && sizeof(K) <= 8
+	                                 && (!std::is_floating_point_v<K> || std::numeric_limits<K>::is_iec559);
+
+	// 能按字节分配的字符串键
+	template<class K>
+	concept __radix_string_key = std::is_convertible_v<const K&, std::string_view>;
+
+	// @brief 与 K 等宽的无符号整数，键映射到它上面后按无符号数比较
+	template<class K>
+	using __radix_uint_t = std::conditional_t<sizeof(K) == 1, uint8_t,
+	                       std::conditional_t<sizeof(K) == 2, uint16_t,
+	                       std::conditional_t<sizeof(K) == 4, uint32_t, uint64_t>>>;
+
+	/**
+	 * @brief 把算术键映射为无符号整数，映射前后大小顺序一致
+	 * @details 有符号整数翻转符号位；浮点数为负时全部取反，否则翻转符号位
+	 *          于是 -0.0 排在 +0.0 前，带符号位的 NaN 排最前，其余 NaN 排最后
+	 */
+	template<class K>
+	inline __radix_uint_t<K> __radix_encode (K key) {
+		using U = __radix_uint_t<K>;
+		constexpr U sign = U(U(1) << (sizeof(U) * 8 - 1));
+		if constexpr (std::is_floating_point_v<K>) {
+			U u = std::bit_cast<U>(key);
+			return (u & sign) ? U(~u) : U(u | sign);
+		} else if constexpr (std::is_signed_v<K>) {
+			return U(U(key) ^ sign);
+		} else {
+			return U(key);
+		}
+	}
+
+	// @brief __radix_encode 的逆映射
+	template<class K>
+	inline K __radix_decode (__radix_uint_t<K> u) {
+		using U = __radix_uint_t<K>;
+		constexpr U sign = U(U(1) << (sizeof(U) * 8 - 1));
+		if constexpr (std::is_floating_point_v<K>) {
+			return std::bit_cast<K>((u & sign) ? U(u ^ sign) : U(~u));
+		} else if constexpr (std::is_signed_v<K>) {
+			return K(U(u ^ sign));
+		} else {
+			return K(u);
+		}
+	}
+
+	/**
+	 * @brief LSD 基数排序：从低位到高位每趟按 Bits 位稳定分配，在 a、b 之间来回搬
+	 * @details 一遍扫描同时统计出所有趟的直方图；某一趟所有元素落在同一个桶里就跳过这一趟
+	 *          keyOf(x) 返回已映射好的无符号整数键；返回排好序的结果所在的数组（a 或 b）
+	 */
+	template<int Bits, class Item, typename KeyOf>
+	Item* __radix_lsd (Item* a, Item* b, ptrdiff_t n, KeyOf keyOf) {
+		static_assert(Bits >= 1 && Bits <= __radix_max_bits, "radix digit must be 1 to 16 bits");
+		using U = std::remove_cvref_t<decltype(keyOf(*a))>;
+		constexpr int passes = (int)((sizeof(U) * 8 + Bits - 1) / Bits);
+		constexpr size_t buckets = size_t(1) << Bits;
+		constexpr U mask = U(buckets - 1);
+
+		std::vector<size_t> count(passes * buckets);
+		for (ptrdiff_t i = 0; i < n; i ++) {
+			U key = keyOf(a[i]);
+			for (int p = 0; p < passes; p ++)
+				count[p * buckets + ((key >> (p * Bits)) & mask)] ++;
+		}
+		for (int p = 0; p < passes; p ++) {
+			size_t* offset = count.data() + p * buckets;
+			if (offset[(keyOf(a[0]) >> (p * Bits)) & mask] == (size_t)n)
+				continue;
+			size_t sum = 0;
+			for (size_t d = 0; d < buckets; d ++) {
+				size_t t = offset[d];
+				offset[d] = sum;
+				sum += t;
+			}
+			for (ptrdiff_t i = 0; i < n; i ++)
+				b[offset[(keyOf(a[i]) >> (p * Bits)) & mask] ++] = a[i];
+			std::swap(a, b);
+		}
+		return a;
+	}
+
+	// @brief 第 depth 个字节所在的桶：字符串已结束为 0，否则为字节值 + 1
+	inline size_t __radix_byte (std::string_view key, size_t depth) {
+		return depth < key.size() ? (size_t)(unsigned char)key[depth] + 1 : 0;
+	}
+
+	// 待排序的键与元素原来的下标
+	template<class K>
+	struct __radix_item {
+		K      key;
+		size_t index;
+	};
+
+	/**
+	 * @brief MSD 基数排序字符串键：从第 depth 个字节起按字节分到 257 个桶（字符串已结束的在最前），再逐桶处理下一个字节
+	 * @details 用显式栈代替递归，键再长也不会爆栈；短桶用插入排序比较剩余的后缀
+	 *          稳定，结果与 std::string 的 operator< 一致（按无符号字节比较）
+	 */
+	inline void __radix_msd (__radix_item<std::string_view>* a, __radix_item<std::string_view>* b, ptrdiff_t n) {
+		struct Task { ptrdiff_t lo, hi; size_t depth; };
+		std::vector<Task> tasks{{0, n, 0}};
+		size_t offset[257];
+		while (!tasks.empty()) {
+			auto [lo, hi, depth] = tasks.back();
+			tasks.pop_back();
+			if (hi - lo <= __radix_msd_insertion_threshold) {
+				for (ptrdiff_t i = lo + 1; i < hi; i ++) {
+					__radix_item<std::string_view> t = a[i];
+					std::string_view key = t.key.substr(depth);
+					ptrdiff_t j = i;
+					for (; j > lo && key < a[j - 1].key.substr(depth); j --)
+						a[j] = a[j - 1];
+					a[j] = t;
+				}
+				continue;
+			}
+			std::fill(offset, offset + 257, 0);
+			for (ptrdiff_t i = lo; i < hi; i ++)
+				offset[__radix_byte(a[i].key, depth)] ++;
+			// 都已结束说明全部相等；都在同一个桶就不用搬，直接看下一个字节
+			if (offset[0] == (size_t)(hi - lo))
+				continue;
+			if (offset[__radix_byte(a[lo].key, depth)] == (size_t)(hi - lo)) {
+				tasks.push_back({lo, hi, depth + 1});
+				continue;
+			}
+			size_t sum = lo;
+			for (size_t d = 0; d < 257; d ++) {
+				size_t t = offset[d];
+				offset[d] = sum;
+				sum += t;
+				if (d > 0 && t > 1)
+					tasks.push_back({(ptrdiff_t)offset[d], (ptrdiff_t)sum, depth + 1});
+			}
+			for (ptrdiff_t i = lo; i < hi; i ++)
+				b[offset[__radix_byte(a[i].key, depth)] ++] = a[i];
+			std::copy(b + lo, b + hi, a + lo);
+		}
+	}
+
+	// @brief 按 items 的顺序重排区间：排序后第 i 个元素是原来的第 items[i].index 个
+	template<class RandomIterator, class Item>
+	void __radix_permute (RandomIterator begin, const Item* items, ptrdiff_t n) {
+		using T = std::iter_value_t<RandomIterator>;
+		std::allocator<T> alloc;
+		T* buffer = alloc.allocate(n);
+		for (ptrdiff_t i = 0; i < n; i ++)
+			new(buffer + i) T(std::move(begin[items[i].index]));
+		for (ptrdiff_t i = 0; i < n; i ++) {
+			begin[i] = std::move(buffer[i]);
+			buffer[i].~T();
+		}
+		alloc.deallocate(buffer, n);
+	}
+
+	// @brief 算术类型的区间直接映射成无符号整数排序再映射回去；Descending 时键取反即为降序
+	template<int Bits, bool Descending, class RandomIterator>
+	void __radix_sort_values (RandomIterator begin, RandomIterator end) {
+		using T = std::iter_value_t<RandomIterator>;
+		using U = __radix_uint_t<T>;
+		ptrdiff_t n = end - begin;
+		if (n < 2)
 			return;
-		ForwardIterator pivot = __quicksort_paritition(begin, end - 1);
-		__quicksort(begin, pivot);
-		__quicksort(pivot + 1, end);
+		std::unique_ptr<U[]> buffer(new U[2 * n]);
+		U* a = buffer.get();
+		for (ptrdiff_t i = 0; i < n; i ++)
+			a[i] = Descending ? U(~__radix_encode<T>(begin[i])) : __radix_encode<T>(begin[i]);
+		U* sorted = __radix_lsd<Bits>(a, a + n, n, [] (U u) { return u; });
+		for (ptrdiff_t i = 0; i < n; i ++)
+			begin[i] = __radix_decode<T>(Descending ? U(~sorted[i]) : sorted[i]);
 	}
 
-	template<class ForwardIterator, typename Func>
-	void __quicksort (ForwardIterator begin, ForwardIterator end, Func comp) {
-		if (begin >= end || begin >= end - 1)
+	/**
+	 * @brief 按 key(x) 升序的稳定基数排序
+	 * @details key 返回算术类型时为 LSD：每趟 Bits 位（默认 8 位一个字节，可选 16 位以减少趟数），O(n · 位宽 / Bits)
+	 *          key 返回字符串（std::string、std::string_view 等）时为 MSD，按无符号字节比较，O(键的总长度)
+	 *          先排好 (键, 下标)，最后一次性移动元素，所以 key 只对每个元素调用一次，元素只搬一次
+	 *          浮点键的顺序：-NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < NaN
+	 */
+	template<int Bits = 8, class RandomIterator, typename Key>
+	void radix_sort (RandomIterator begin, RandomIterator end, Key key) {
+		using R = std::invoke_result_t<Key&, std::iter_reference_t<RandomIterator>>;
+		using K = std::remove_cvref_t<R>;
+		ptrdiff_t n = end - begin;
+		if (n < 2)
 			return;
-		ForwardIterator pivot = __quicksort_paritition(begin, end - 1, comp);
-		__quicksort(begin, pivot, comp);
-		__quicksort(pivot + 1, end, comp);
+		if constexpr (__radix_arithmetic_key<K>) {
+			using Item = __radix_item<__radix_uint_t<K>>;
+			std::unique_ptr<Item[]> buffer(new Item[2 * n]);
+			Item* a = buffer.get();
+			for (ptrdiff_t i = 0; i < n; i ++)
+				a[i] = {__radix_encode<K>(std::invoke(key, begin[i])), (size_t)i};
+			Item* sorted = __radix_lsd<Bits>(a, a + n, n, [] (const Item& x) { return x.key; });
+			__radix_permute(begin, sorted, n);
+		} else {
+			static_assert(__radix_string_key<K>, "radix_sort key must be arithmetic or string-like");
+			using Item = __radix_item<std::string_view>;
+			// key 返回临时对象时先存下来，保证 string_view 有效
+			std::vector<K> keys;
+			if constexpr (!std::is_reference_v<R>)
+				keys.reserve(n);
+			std::unique_ptr<Item[]> buffer(new Item[2 * n]);
+			Item* a = buffer.get();
+			for (ptrdiff_t i = 0; i < n; i ++) {
+				if constexpr (std::is_reference_v<R>) {
+					a[i] = {std::string_view(std::invoke(key, begin[i])), (size_t)i};
+				} else {
+					keys.push_back(std::invoke(key, begin[i]));
+					a[i] = {std::string_view(keys.back()), (size_t)i};
+				}
+			}
+			__radix_msd(a, a + n, n);
+			__radix_permute(begin, a, n);
+		}
 	}
 
-	template<class ForwardIterator>
-	void sort (ForwardIterator begin, ForwardIterator end) {
-		__quicksort(begin, end);
+	/**
+	 * @brief 按元素本身升序的基数排序：算术类型为 LSD，std::string 等字符串为 MSD
+	 */
+	template<int Bits = 8, class RandomIterator>
+	void radix_sort (RandomIterator begin, RandomIterator end) {
+		using T = std::iter_value_t<RandomIterator>;
+		if constexpr (__radix_arithmetic_key<T>)
+			__radix_sort_values<Bits, false>(begin, end);
+		else
+			zyz::radix_sort<Bits>(begin, end, [] (const T& x) -> const T& { return x; });
 	}
 
-	template<class ForwardIterator, typename Func>
-	void sort (ForwardIterator begin, ForwardIterator end, Func comp) {
-		__quicksort(begin, end, comp);
+	// zyz::sort 对算术类型配 zyz::less / zyz::greater 的区间自动改用基数排序
+	template<class T, typename Func>
+	concept __radix_sortable = __radix_arithmetic_key<T>
+	                           && (std::is_same_v<Func, less<T>> || std::is_same_v<Func, greater<T>>);
+
+	/**
+	 * @brief 排序（不稳定），comp 为严格弱序
+	 * @details pattern-defeating quicksort：九数/三数取中选基准，小区间插入排序，
+	 *          算术类型配 less/greater 时用无分支块分区，连续 log2(n) 次很不均衡就改用堆排序
+	 *          有序、逆序、全相等等输入为线性或 O(n log n)，最坏 O(n log n)，栈深度 O(log n)
+	 *          算术类型配 zyz::less / zyz::greater 且区间不短于 __radix_sort_threshold<T> 时改用基数排序（见 radix_sort），
+	 *          需要额外 O(n) 的缓冲区；浮点数中 -0.0 排在 +0.0 前，NaN 按符号位排在两端
+	 */
+	template<class RandomIterator, typename Func>
+	void sort (RandomIterator begin, RandomIterator end, Func comp) {
+		if (end - begin < 2)
+			return;
+		using T = std::iter_value_t<RandomIterator>;
+		if constexpr (__radix_sortable<T, Func>) {
+			if (end - begin >= __radix_sort_threshold<T>) {
+				__radix_sort_values<8, std::is_same_v<Func, greater<T>>>(begin, end);
+				return;
+			}
+		}
+		__pdqsort_loop<__branchless_compare<T, Func>>(begin, end, comp, __log2(end - begin), true);
+	}
+
+	template<class RandomIterator>
+	void sort (RandomIterator begin, RandomIterator end) {
+		zyz::sort(begin, end, less<std::iter_value_t<RandomIterator>>());
+	}
+
+	namespace execution {
+
+		// @brief 顺序执行
+		struct sequenced_policy {};
+
+		// @brief 并行执行
+		// threads 为使用的线程数（0 表示 std::thread::hardware_concurrency()）
+		// 区间短于 cutoff 时直接顺序执行，线程开销不划算
+		struct parallel_policy {
+			static constexpr ptrdiff_t DEFAULT_CUTOFF = 1 << 16;
+
+			explicit constexpr parallel_policy (int _threads = 0, ptrdiff_t _cutoff = DEFAULT_CUTOFF) :
+				threads(_threads), cutoff(_cutoff) {}
+
+			[[nodiscard]] int getThreads () const {
+				return threads > 0 ? threads : std::max(1, (int)std::thread::hardware_concurrency());
+			}
+
+			int       threads;	///< 线程数
+			ptrdiff_t cutoff;	///< 顺序执行的阈值
+		};
+
+		inline constexpr sequenced_policy seq{};
+		inline constexpr parallel_policy  par{};
+
+	}
+
+	template<class Policy>
+	concept __execution_policy = std::is_same_v<std::remove_cvref_t<Policy>, execution::sequenced_policy>
+	                             || std::is_same_v<std::remove_cvref_t<Policy>, execution::parallel_policy>;
+
+	// @brief 用 threads 个线程（含当前线程）领取并执行 tasks 个任务 fn(i)
+	template<typename Func>
+	void __parallel_for (int threads, ptrdiff_t tasks, Func fn) {
+		std::atomic<ptrdiff_t> next{0};
+		auto worker = [&] {
+			for (ptrdiff_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < tasks; )
+				fn(i);
+		};
+		std::vector<std::thread> pool;
+		for (int t = 1; t < std::min<ptrdiff_t>(threads, tasks); t ++)
+			pool.emplace_back(worker);
+		worker();
+		for (std::thread& t : pool)
+			t.join();
+	}
+
+	/**
+	 * @brief 合并路径：a、b 稳定合并后的前 d 个元素中有几个来自 a
+	 * @details 相等时 a 在前，与顺序合并的结果一致
+	 */
+	template<class T, typename Func>
+	ptrdiff_t __merge_path (const T* a, ptrdiff_t na, const T* b, ptrdiff_t nb, ptrdiff_t d, Func comp) {
+		ptrdiff_t lo = std::max((ptrdiff_t)0, d - nb), hi = std::min(d, na);
+		while (lo < hi) {
+			ptrdiff_t mid = (lo + hi) / 2;
+			if (!comp(b[d - mid - 1], a[mid]))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	// @brief 把 src 放到 dst：dst 未构造时移动构造，否则移动赋值
+	template<class T>
+	inline void __move_to (T& src, T* dst, bool constructed) {
+		if (constructed)
+			*dst = std::move(src);
+		else
+			new(dst) T(std::move(src));
+	}
+
+	/**
+	 * @brief 并行排序：分块并行 pdqsort，再逐轮两两并行合并
+	 * @details 区间均分为线程数个块，各线程用顺序的 zyz::sort 排好各自的块
+	 *          之后每轮把相邻两块合并到另一块缓冲区（与原区间交替使用）
+	 *          每轮的全部输出按合并路径切成与线程数相当的若干段，各段互不重叠、并行合并，最后一轮也能用满所有线程
+	 *          需要与区间等长的额外缓冲区；结果与顺序版本一样是排好序的同一组元素
+	 */
+	template<class RandomIterator, typename Func>
+	void __parallel_sort (const execution::parallel_policy& policy, RandomIterator begin, RandomIterator end, Func comp) {
+		using T = std::iter_value_t<RandomIterator>;
+		ptrdiff_t n = end - begin;
+		int threads = policy.getThreads();
+		if (threads <= 1 || n < std::max(policy.cutoff, (ptrdiff_t)2 * threads)) {
+			zyz::sort(begin, end, comp);
+			return;
+		}
+
+		// 块的边界
+		std::vector<ptrdiff_t> runs(threads + 1);
+		for (int i = 0; i <= threads; i ++)
+			runs[i] = n * i / threads;
+		__parallel_for(threads, threads, [&] (ptrdiff_t i) {
+			zyz::sort(begin + runs[i], begin + runs[i + 1], comp);
+		});
+
+		T* data = std::to_address(begin);
+		std::allocator<T> alloc;
+		T* buffer = alloc.allocate(n);
+		bool bufferConstructed = false;
+		T* src = data;
+		T* dst = buffer;
+		ptrdiff_t grain = std::max((ptrdiff_t)1, n / threads);
+
+		// 一段输出：第 pair 对的合并结果中 [from, to) 这一段，其中前 i 个 / 到 iEnd 为止来自前一块
+		struct Piece { ptrdiff_t pair, from, to, i, iEnd; };
+		while (runs.size() > 2) {
+			bool dstConstructed = dst == data || bufferConstructed;
+			std::vector<Piece> pieces;
+			ptrdiff_t pairs = (ptrdiff_t)runs.size() / 2;	// 块数除以 2 向上取整
+			for (ptrdiff_t p = 0; p < pairs; p ++) {
+				ptrdiff_t lo = runs[2 * p], hi = runs[std::min<size_t>(2 * p + 2, runs.size() - 1)];
+				for (ptrdiff_t from = 0; from < hi - lo; from += grain)
+					pieces.push_back({p, from, std::min(from + grain, hi - lo), 0, 0});
+			}
+			auto pairRange = [&] (ptrdiff_t p, T*& a, ptrdiff_t& na, T*& b, ptrdiff_t& nb) {
+				ptrdiff_t lo = runs[2 * p];
+				ptrdiff_t mid = runs[std::min<size_t>(2 * p + 1, runs.size() - 1)];
+				ptrdiff_t hi = runs[std::min<size_t>(2 * p + 2, runs.size() - 1)];
+				a = src + lo;
+				b = src + mid;
+				na = mid - lo;
+				nb = hi - mid;
+			};
+			// 先算出所有分段点再开始搬：搬动会改变元素（移动后的对象），不能边搬边二分
+			__parallel_for(threads, (ptrdiff_t)pieces.size(), [&] (ptrdiff_t k) {
+				Piece& piece = pieces[k];
+				T *a, *b;
+				ptrdiff_t na, nb;
+				pairRange(piece.pair, a, na, b, nb);
+				piece.i = __merge_path(a, na, b, nb, piece.from, comp);
+				piece.iEnd = __merge_path(a, na, b, nb, piece.to, comp);
+			});
+			__parallel_for(threads, (ptrdiff_t)pieces.size(), [&] (ptrdiff_t k) {
+				const Piece& piece = pieces[k];
+				T *a, *b;
+				ptrdiff_t na, nb;
+				pairRange(piece.pair, a, na, b, nb);
+				ptrdiff_t i = piece.i, iEnd = piece.iEnd;
+				ptrdiff_t j = piece.from - i, jEnd = piece.to - iEnd;
+				T* out = dst + (a - src) + piece.from;
+				while (i < iEnd && j < jEnd) {
+					if (comp(b[j], a[i]))
+						__move_to(b[j ++], out ++, dstConstructed);
+					else
+						__move_to(a[i ++], out ++, dstConstructed);
+				}
+				while (i < iEnd)
+					__move_to(a[i ++], out ++, dstConstructed);
+				while (j < jEnd)
+					__move_to(b[j ++], out ++, dstConstructed);
+			});
+			if (dst == buffer)
+				bufferConstructed = true;
+			std::vector<ptrdiff_t> merged;
+			for (size_t i = 0; i < runs.size(); i += 2)
+				merged.push_back(runs[i]);
+			if (merged.back() != n)
+				merged.push_back(n);
+			runs.swap(merged);
+			std::swap(src, dst);
+		}
+
+		// 结果在缓冲区里就搬回原区间
+		if (src == buffer) {
+			__parallel_for(threads, threads, [&] (ptrdiff_t t) {
+				for (ptrdiff_t i = n * t / threads; i < n * (t + 1) / threads; i ++)
+					data[i] = std::move(buffer[i]);
+			});
+		}
+		if (bufferConstructed && !std::is_trivially_destructible_v<T>)
+			for (ptrdiff_t i = 0; i < n; i ++)
+				buffer[i].~T();
+		alloc.deallocate(buffer, n);
+	}
+
+	/**
+	 * @brief 按执行策略排序：execution::seq 为顺序的 zyz::sort，execution::parallel_policy 见 __parallel_sort
+	 * @details 并行版本要求迭代器连续存放（如 zyz::Vector、数组、std::vector）
+	 */
+	template<__execution_policy Policy, std::contiguous_iterator RandomIterator, typename Func>
+	void sort (Policy&& policy, RandomIterator begin, RandomIterator end, Func comp) {
+		if constexpr (std::is_same_v<std::remove_cvref_t<Policy>, execution::parallel_policy>)
+			__parallel_sort(policy, begin, end, comp);
+		else
+			zyz::sort(begin, end, comp);
+	}
+
+	template<__execution_policy Policy, std::contiguous_iterator RandomIterator>
+	void sort (Policy&& policy, RandomIterator begin, RandomIterator end) {
+		zyz::sort(std::forward<Policy>(policy), begin, end, less<std::iter_value_t<RandomIterator>>());
 	}
 }
 
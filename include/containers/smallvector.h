@@ -0,0 +1,192 @@
+#ifndef _SMALL_VECTOR_H_
+#define _SMALL_VECTOR_H_
+
+#include "vector.h"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace zyz {
+
+	// @brief 自带 N 个元素内联缓冲区的配置器
+	// 不超过 N 个元素的配置直接给出内联缓冲区，更大的（或内联缓冲区正被占用时）交给内层配置器 Alloc
+	// 内联缓冲区只属于这个配置器对象：复制时不复制缓冲区内容，两个对象之间不相等，容器 复制/移动/交换 时也不传播
+	template<class T, size_t N, typename Alloc = Allocator<T>>
+	class InlineAllocator {
+		static_assert(N > 0, "InlineAllocator needs at least one inline element");
+	public:
+		using value_type = T;
+		using pointer = T *;
+		using const_pointer = const T *;
+		using reference = T &;
+		using const_reference = const T &;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+
+		using propagate_on_container_copy_assignment = std::false_type;
+		using propagate_on_container_move_assignment = std::false_type;
+		using propagate_on_container_swap = std::false_type;
+		using is_always_equal = std::false_type;
+
+		InlineAllocator() : alloc(), used(false) {}
+
+		explicit InlineAllocator(const Alloc &_alloc) : alloc(_alloc), used(false) {}
+
+		// 只复制内层配置器，新对象的内联缓冲区为空
+		InlineAllocator(const InlineAllocator &that) : alloc(that.alloc), used(false) {}
+
+		InlineAllocator &operator=(const InlineAllocator &that) {
+			alloc = that.alloc;
+			return *this;
+		}
+
+		pointer allocate(size_type n) {
+			if (!used && n <= N) {
+				used = true;
+				return inlineBuffer();
+			}
+			return alloc.allocate(n);
+		}
+
+		void deallocate(pointer p, size_type n) {
+			if (isInline(p)) {
+				used = false;
+				return;
+			}
+			alloc.deallocate(p, n);
+		}
+
+		// @brief 内联缓冲区在 N 以内原地扩展；堆上的块交给内层配置器试一下
+		bool tryExpand(pointer p, size_type n, size_type newN) {
+			if (isInline(p))
+				return newN <= N;
+			if constexpr (requires { alloc.tryExpand(p, n, newN); })
+				return alloc.tryExpand(p, n, newN);
+			return false;
+		}
+
+		template<class ...Args>
+		void construct(pointer p, Args&& ...args) {
+			std::allocator_traits<Alloc>::construct(alloc, p, std::forward<Args>(args)...);
+		}
+
+		void destroy(pointer p) {
+			std::allocator_traits<Alloc>::destroy(alloc, p);
+		}
+
+		InlineAllocator select_on_container_copy_construction() const {
+			return InlineAllocator(std::allocator_traits<Alloc>::select_on_container_copy_construction(alloc));
+		}
+
+		[[nodiscard]] bool isInline(const_pointer p) const noexcept {
+			return p == inlineBuffer();
+		}
+
+		[[nodiscard]] const Alloc &getAllocator() const noexcept {
+			return alloc;
+		}
+
+	private:
+		pointer inlineBuffer() const noexcept {
+			return reinterpret_cast<pointer>(const_cast<unsigned char *>(buffer));
+		}
+
+		Alloc alloc;	///< 超出内联容量时使用的配置器
+		bool  used;		///< 内联缓冲区是否正被占用
+		alignas(T) unsigned char buffer[N * sizeof(T)];	///< 内联缓冲区
+	};
+
+	// 内联缓冲区只能由自己归还
+	template<class T, size_t N, typename Alloc>
+	bool operator==(const InlineAllocator<T, N, Alloc> &a, const InlineAllocator<T, N, Alloc> &b) noexcept {
+		return &a == &b;
+	}
+
+	template<class T, size_t N, typename Alloc>
+	bool operator!=(const InlineAllocator<T, N, Alloc> &a, const InlineAllocator<T, N, Alloc> &b) noexcept {
+		return &a != &b;
+	}
+
+	// @brief 前 N 个元素存放在对象内部的 zyz::Vector
+	// 就是配置器为 InlineAllocator 的 zyz::Vector：构造时直接拿到容量 N 的内联缓冲区，不超过 N 个元素时不碰内存池
+	// 超过 N 时照常倍增扩容搬到 Alloc 配置的内存上；接口与 zyz::Vector 相同
+	// 内联的元素无法被接管，移动时只有已搬到堆上的缓冲区直接接管，否则逐个移动元素
+	template<class T, size_t N, typename Alloc = Allocator<T>>
+	class SmallVector : public Vector<T, InlineAllocator<T, N, Alloc>> {
+		using Base = Vector<T, InlineAllocator<T, N, Alloc>>;
+	public:
+		using allocator_type = Alloc;
+		using size_type      = typename Base::size_type;
+
+		SmallVector() : Base() { this->reserve(N); }
+
+		explicit SmallVector(const Alloc &alloc) : Base(InlineAllocator<T, N, Alloc>(alloc)) { this->reserve(N); }
+
+		SmallVector(int n, const T &data, const Alloc &alloc = Alloc()) :
+			Base(n, data, InlineAllocator<T, N, Alloc>(alloc)) {}
+
+		template<std::input_iterator Iterator>
+		SmallVector(Iterator first, Iterator last, const Alloc &alloc = Alloc()) :
+			Base(first, last, InlineAllocator<T, N, Alloc>(alloc)) {}
+
+		// 与其它构造函数一样先拿到内联缓冲区，空的 v 也不会留下容量为 0 的缓冲区
+		SmallVector(const SmallVector &v) :
+			Base(InlineAllocator<T, N, Alloc>(std::allocator_traits<Alloc>::select_on_container_copy_construction(v.get_allocator())))
+		{
+			this->reserve(std::max(v.size(), (size_type)N));
+			for (auto it = v.begin(); it != v.end(); it ++) {
+				std::allocator_traits<InlineAllocator<T, N, Alloc>>::construct(this->_alloc, this->_finish, *it);
+				this->_finish ++;
+			}
+		}
+
+		SmallVector(SmallVector &&v) noexcept(std::is_nothrow_move_constructible_v<T>) :
+			Base(InlineAllocator<T, N, Alloc>(v.get_allocator()))
+		{
+			moveFrom(v);
+		}
+
+		SmallVector &operator=(const SmallVector &v) {
+			Base::operator=(v);
+			return *this;
+		}
+
+		SmallVector &operator=(SmallVector &&v) noexcept(std::is_nothrow_move_constructible_v<T>) {
+			if (this == &v)
+				return *this;
+			this->release();
+			moveFrom(v);
+			return *this;
+		}
+
+		// @brief 元素是否还在内联缓冲区中
+		[[nodiscard]] bool isSmall() const noexcept {
+			return this->_start == nullptr || this->_alloc.isInline(this->_start);
+		}
+
+		[[nodiscard]] allocator_type get_allocator() const noexcept {
+			return this->_alloc.getAllocator();
+		}
+
+	private:
+		// @brief 本容器为空且没有缓冲区时调用：v 在堆上且内层配置器相等就接管，否则逐个移动
+		void moveFrom(SmallVector &v) {
+			if (!v.isSmall() && v._alloc.getAllocator() == this->_alloc.getAllocator()) {
+				this->takeStorage(v);
+				v.reserve(N);
+				return;
+			}
+			this->reserve(std::max(v.size(), (size_type)N));
+			for (auto it = v.begin(); it != v.end(); it ++) {
+				std::allocator_traits<InlineAllocator<T, N, Alloc>>::construct(this->_alloc, this->_finish, std::move(*it));
+				this->_finish ++;
+			}
+			v.clear();
+		}
+	};
+
+}
+
+#endif
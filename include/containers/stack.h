@@ -5,22 +5,26 @@
 
 namespace zyz {
 
-    template<class T, typename Alloc = Allocator<T>>
+    // @brief 栈，底层容器默认为 zyz::Vector，也可以换成 zyz::SmallVector<T, N, Alloc> 让浅栈不碰内存池
+    template<class T, typename Alloc = Allocator<T>, class Container = Vector<T, Alloc>>
     class Stack {
 	public:
 		Stack() = default;
+		explicit Stack(const Alloc& alloc) : self(alloc) {}
 		~Stack() { self.clear(); }
 
 		void push (const T& data) { self.push_back(data); }
-		void push (T&& data) { self.push_back(data); }
+		void push (T&& data) { self.push_back(std::move(data)); }
 
 		void pop () { self.pop_back(); }
 
 		T& top() { return self.back(); }
 
 		int size () { return self.size(); }
+
+		Alloc get_allocator () const { return self.get_allocator(); }
 	private:
-		Vector<T, Alloc> self;
+		Container self;
 	};
 
 };
\ No newline at end of file
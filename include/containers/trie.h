@@ -3,8 +3,12 @@
 
 #include "mempool.h"
 #include "allocator.h"
+#include "stack.h"
+#include "smallvector.h"
+#include "algorithm.h"
 #include <string>
 #include <functional>
+#include <memory>
 #include <vector>
 #include <iostream>
 
@@ -48,16 +52,29 @@ namespace zyz {
 		using const_reference =     const T &;
 		using size_type       =     size_t;
 		using difference_type =     ptrdiff_t;
-		using Self            =     Trie<T>;
+		using allocator_type  =     Alloc;
+		using Self            =     Trie<T, Alloc>;
 		using iterator        =     pointer;
 		using const_iterator  =     const_pointer;
     public:
         /* 字典树构造初始化：新建根节点 */
         Trie();
 
-        /* 把 root delete(delete内有递归效果)掉 */
+        /* 使用 alloc 所绑定的内存池构造 */
+        explicit Trie(const Alloc& _alloc);
+
+        /* 接管 release 交出的整棵树（如重启后从持久化内存池的根表中取回） */
+        Trie(const Alloc& _alloc, void* _root);
+
+        /* 把 root 连同整棵树释放掉 */
         ~Trie();
 
+        /* 交出整棵树，返回根节点地址，之后本对象只能析构 */
+        void* release();
+
+        Trie(const Trie& that) = delete;
+        Trie& operator = (const Trie& that) = delete;
+
         /* 在字典树上路径为s的终点处存入value */
         void insert(const std::string& s, T value);
 
@@ -73,102 +90,160 @@ namespace zyz {
         /* 打印出所有的 key（不管是否存在 value） */
         void dfs ();
 
-        /* 做值为引用的键值对（遍历支持类似于 map 的结构化绑定） */
-        std::vector<std::pair<std::string, T&>> getKV ();
+        /* 做值为引用的键值对（遍历支持类似于 map 的结构化绑定），byteOrder 为真时按键的字节序（与 std::map 相同）排列 */
+        std::vector<std::pair<std::string, T&>> getKV (bool byteOrder = false);
 
         /* 重载 [] ，可以用字符串当下标操作值 */
         T& operator [](const std::string& s);
-    private:
 
+        /* 返回配置器实例 */
+        allocator_type get_allocator () const;
+    private:
+        struct TrieNode;
+
+        // 节点之间的指针都用配置器的指针类型，配置器用 zyz::OffsetPtr 时整棵树与基址无关
+        using NodeAlloc  = typename std::allocator_traits<Alloc>::template rebind_alloc<TrieNode>;
+        using NodePtr    = typename std::allocator_traits<NodeAlloc>::pointer;
+        using ChildAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<NodePtr>;
+        using ChildPtr   = typename std::allocator_traits<ChildAlloc>::pointer;
+        using ValuePtr   = typename std::allocator_traits<Alloc>::pointer;
+
+        // 插入/删除时记下的一路节点：键不长于 PATH_INLINE 时不配置内存
+        // 超出时配置器是普通指针就用同一个内存池，否则（如持久化内存池）临时数组用 std::allocator
+        static constexpr size_t PATH_INLINE = 32;
+        using PathAlloc  = std::conditional_t<std::is_pointer_v<ValuePtr>,
+                                              typename std::allocator_traits<Alloc>::template rebind_alloc<TrieNode*>,
+                                              std::allocator<TrieNode*>>;
+        using Path       = SmallVector<TrieNode*, PATH_INLINE, PathAlloc>;
 
         /**
          * @brief 字典树节点
          */
         struct TrieNode {
-            TrieNode**   child; ///< 儿子，默认有 26+26+10+1=63 个
-            T*           value; ///< 节点指向的对应类型的值
+            ChildPtr     child; ///< 儿子，默认有 26+26+10+1=63 个
+            ValuePtr     value; ///< 节点指向的对应类型的值
             int          size;  ///< 以本节点为根的子树中值的数量
 
-            /* 创建有 63 个元素的 child 指针数组，别的都初始化为 0 */
-            TrieNode();
+        } *root; ///< 根节点（本次运行中的地址）
+
+        Alloc       alloc;       ///< 值的配置器
+        NodeAlloc   nodeAlloc;   ///< 节点的配置器（与 alloc 绑定同一个内存池）
+        ChildAlloc  childAlloc;  ///< 儿子数组的配置器（与 alloc 绑定同一个内存池）
+
+        static constexpr size_t NODE_BATCH = 16;  ///< 一次批量配置的最大节点数
+        std::vector<NodePtr> spare;              ///< 批量配置好、尚未使用的节点（已带儿子数组）
+        size_t               batch = 1;          ///< 下一次批量配置的节点数，从 1 倍增到 NODE_BATCH
 
-            /* 析构本节点与以本节点为根子树所有节点 */
-            ~TrieNode ();
+        /* 用配置器新建节点：63 个元素的 child 指针数组，别的都初始化为 0 */
+        TrieNode* newNode ();
 
-			/* 使用 allocator 对节点分配内存 */
-			void* operator new (std::size_t size);
+        /* 批量配置 batch 个节点及其儿子数组放入 spare */
+        void refillSpare ();
 
-			/* 使用 allocator 对节点释放内存 */
-			void operator delete (void* ptr);
-        } *root; ///< 根节点
+        /* 释放本节点与以本节点为根子树所有节点 */
+        void deleteNode (NodePtr p);
 
+        /* 把一批节点连同儿子数组批量还给配置器 */
+        void freeNodes (std::vector<NodePtr>& nodes);
 
+        /* 路径数组超出内联容量时用的配置器 */
+        PathAlloc pathAlloc () const;
     };
 
     /**
-     * @brief 节点构造初始化
+     * @brief 用配置器新建节点
      * 
      * @tparam T value参数
+     * @return 新节点
      * 
      * @details 创建有 63 个元素的 child 指针数组，别的都初始化为 0
+     *          节点从 spare 中取，取空了先批量补充；批量配置失败时退回逐个配置
      */
     template <class T, typename Alloc>
-    Trie<T, Alloc>::TrieNode::TrieNode() :
-			child(Allocator<TrieNode*>::allocate(63)), value(nullptr), size(0) {
+    typename Trie<T, Alloc>::TrieNode* Trie<T, Alloc>::newNode() {
+        if (spare.empty())
+            refillSpare();
+        TrieNode* p;
+        if (!spare.empty()) {
+            p = std::to_address(spare.back());
+            spare.pop_back();
+        } else {
+            p = std::to_address(nodeAlloc.allocate(1));
+            p->child = childAlloc.allocate(63);
+        }
+        p->value = nullptr;
+        p->size = 0;
         for (int i = 0; i < 63; i ++)
-            child[i] = nullptr;
+            p->child[i] = nullptr;
+        return p;
     }
 
     /**
-     * @brief 节点析构
+     * @brief 批量补充备用节点
+     *
+     * @tparam T value类型
+     *
+     * @details 节点与儿子数组各批量配置一次，两者数量不一致时多出的节点还回去
+     *          每次的数量从 1 倍增到 NODE_BATCH：空树或很小的树只配置用到的节点，不会一构造就占着一批备用节点
+     */
+    template <class T, typename Alloc>
+    void Trie<T, Alloc>::refillSpare() {
+        NodePtr  nodes[NODE_BATCH];
+        ChildPtr children[NODE_BATCH];
+        size_t n = zyz::allocateBatch(nodeAlloc, 1, nodes, batch);
+        batch = std::min(batch * 2, NODE_BATCH);
+        size_t m = zyz::allocateBatch(childAlloc, 63, children, n);
+        if (m < n)
+            zyz::deallocateBatch(nodeAlloc, nodes + m, 1, n - m);
+        for (size_t i = 0; i < m; i ++) {
+            nodes[i]->child = children[i];
+            spare.push_back(nodes[i]);
+        }
+    }
+
+    /**
+     * @brief 释放节点
      * 
      * @tparam T value类型
+     * @param p  被释放的节点
      * 
-     * @details 采用类似于递归的连锁 delete
-     *          如果哈希第 i 个桶有儿子，就递归地去 delete 这个儿子
-     *          最后要把儿子数组、权值删掉（删之前要判断是否为空，删之后要设置为空）
+     * @details 先遍历出整棵子树，析构权值
+     *          再把权值、儿子数组、节点各自批量还给配置器
      */
     template <class T, typename Alloc>
-    Trie<T, Alloc>::TrieNode::~TrieNode() {
-        if (child) {
+    void Trie<T, Alloc>::deleteNode(NodePtr p) {
+        std::vector<NodePtr> nodes = {p};
+        std::vector<ValuePtr> values;
+        for (size_t k = 0; k < nodes.size(); k ++) {
+            TrieNode* q = std::to_address(nodes[k]);
             for (int i = 0; i < 63; i ++) {
-                if (child[i]) {
-					delete child[i];
-                    child[i] = nullptr;
-                }
+                if (q->child[i])
+                    nodes.push_back(q->child[i]);
+            }
+            if (q->value) {
+                q->value->~T();
+                values.push_back(q->value);
             }
-			Allocator<TrieNode*>::deallocate(child, 63);
-            child = nullptr;
-        }
-        if (value) {
-			value->~T();
-            Alloc::deallocate(value, 1);
-            value = nullptr;
         }
+        zyz::deallocateBatch(alloc, values.data(), 1, values.size());
+        freeNodes(nodes);
     }
 
-	/**
-	 * @brief 使用 allocator 对节点分配内存
-	 * @tparam T 树值类型
-	 * @tparam Alloc 分配器
-	 * @param size 分配大小
-	 * @return 分配后的首地址
-	 */
-	template<class T, typename Alloc>
-	void* Trie<T, Alloc>::TrieNode::operator new (std::size_t size) {
-		return Allocator<TrieNode>::allocate(1);
-	}
-
-	/**
-	 * @brief 使用 allocator 对节点释放内存
-	 * @tparam T 树值类型
-	 * @tparam Alloc 分配器
-	 * @param ptr 待释放首地址
-	 */
-	template<class T, typename Alloc>
-	void Trie<T, Alloc>::TrieNode::operator delete (void* ptr) {
-		Allocator<TrieNode>::deallocate(reinterpret_cast<TrieNode*>(ptr), 1);
-	}
+    /**
+     * @brief 把一批节点连同儿子数组批量还给配置器
+     *
+     * @tparam T value类型
+     * @param nodes 被释放的节点（调用后清空）
+     */
+    template <class T, typename Alloc>
+    void Trie<T, Alloc>::freeNodes(std::vector<NodePtr>& nodes) {
+        std::vector<ChildPtr> children(nodes.size());
+        for (size_t i = 0; i < nodes.size(); i ++)
+            children[i] = nodes[i]->child;
+        zyz::deallocateBatch(childAlloc, children.data(), 63, children.size());
+        zyz::deallocateBatch(nodeAlloc, nodes.data(), 1, nodes.size());
+        nodes.clear();
+    }
 
 		/**
 		 * @brief 字典树构造初始化
@@ -178,21 +253,64 @@ namespace zyz {
 		 * @details 新建根节点
 		 */
     template <class T, typename Alloc>
-    Trie<T, Alloc>::Trie() {
-		root = new TrieNode();
+    Trie<T, Alloc>::Trie() : nodeAlloc(alloc), childAlloc(alloc) {
+		root = newNode();
+    }
+
+    /**
+     * @brief 使用 alloc 所绑定的内存池构造
+     *
+     * @tparam T value类型
+     * @param _alloc 配置器，节点与儿子数组用它 rebind 出的配置器
+     */
+    template <class T, typename Alloc>
+    Trie<T, Alloc>::Trie(const Alloc& _alloc) : alloc(_alloc), nodeAlloc(_alloc), childAlloc(_alloc) {
+        root = newNode();
     }
 
     /**
-     * @brief 把 root delete(delete内有递归效果)掉
+     * @brief 把 root 连同整棵树释放掉
      * 
      * @tparam T value类型
      */
     template <class T, typename Alloc>
     Trie<T, Alloc>::~Trie() {
-        delete root;
+        if (root)
+            deleteNode(root);
+        freeNodes(spare);
         root = nullptr;
     }
 
+    /**
+     * @brief 接管 release 交出的整棵树
+     *
+     * @tparam T value类型
+     * @param _alloc 配置器，须与建树时绑定同一个内存池
+     * @param _root  release 返回的根节点在本次运行中的地址
+     *
+     * @details 不复制也不遍历，配合 PersistentAllocator 时重启后只需映射文件就能继续使用
+     */
+    template <class T, typename Alloc>
+    Trie<T, Alloc>::Trie(const Alloc& _alloc, void* _root) : alloc(_alloc), nodeAlloc(_alloc), childAlloc(_alloc) {
+        root = reinterpret_cast<TrieNode*>(_root);
+    }
+
+    /**
+     * @brief 交出整棵树
+     *
+     * @tparam T value类型
+     * @return 根节点地址，交给持久化内存池的 setRoot 保存，之后用 Trie(alloc, root) 接管
+     *
+     * @details 备用节点还给配置器，树本身不再归本对象所有，之后本对象只能析构
+     */
+    template <class T, typename Alloc>
+    void* Trie<T, Alloc>::release() {
+        void* ret = root;
+        freeNodes(spare);
+        root = nullptr;
+        return ret;
+    }
+
     /**
      * @brief 在字典树上路径为s的终点处存入value
      * 
@@ -206,18 +324,19 @@ namespace zyz {
      */
     template <class T, typename Alloc>
     void Trie<T, Alloc>::insert(const std::string &s, T _value) {
-        std::vector<TrieNode*> path = {root};
+        Path path{pathAlloc()};
+        path.push_back(root);
         TrieNode* p = root;
         for (char c : s) {
             if (!p->child[__trie_ctoi(c)]) {
-                p->child[__trie_ctoi(c)] = new TrieNode();
+                p->child[__trie_ctoi(c)] = newNode();
             }
-            p = p->child[__trie_ctoi(c)];
+            p = std::to_address(p->child[__trie_ctoi(c)]);
             path.push_back(p);
         }
         if (!p->value) {
-            p->value = Alloc::allocate(1);
-			new(p->value) T(_value);
+            p->value = alloc.allocate(1);
+			new(std::to_address(p->value)) T(_value);
             for (int i = 0; i < path.size(); i ++)
                 path[i]->size ++;
         } else
@@ -239,9 +358,9 @@ namespace zyz {
         for (char c : s) {
             if (!p->child[__trie_ctoi(c)])
                 return nullptr;
-            p = p->child[__trie_ctoi(c)];
+            p = std::to_address(p->child[__trie_ctoi(c)]);
         }
-        return p->value;
+        return std::to_address(p->value);
     }
 
     /**
@@ -255,18 +374,19 @@ namespace zyz {
      */
     template <class T, typename Alloc> 
     T& Trie<T, Alloc>::operator[](const std::string &s) {
-        std::vector<TrieNode*> path;
+        Path path{pathAlloc()};
         TrieNode* p = root;
         for (char c : s) {
             path.push_back(p);
             if (!p->child[__trie_ctoi(c)]) {
-                p->child[__trie_ctoi(c)] = new TrieNode();
+                p->child[__trie_ctoi(c)] = newNode();
             }
-            p = p->child[__trie_ctoi(c)];
+            p = std::to_address(p->child[__trie_ctoi(c)]);
         }
         path.push_back(p);
         if (!p->value) {
-            p->value = Alloc::allocate(1);
+            p->value = alloc.allocate(1);
+            new(std::to_address(p->value)) T();
             for (int i = 0; i < path.size(); i ++) {
                 path[i]->size ++;
             }
@@ -299,27 +419,28 @@ namespace zyz {
      */
     template <class T, typename Alloc>
     void Trie<T, Alloc>::erase (const std::string& s) {
-        std::vector<TrieNode*> path = {root};
+        Path path{pathAlloc()};
+        path.push_back(root);
         TrieNode* p = root;
         for (char c : s) {
             if (!p->child[__trie_ctoi(c)])
                 return;
-            p = p->child[__trie_ctoi(c)];
+            p = std::to_address(p->child[__trie_ctoi(c)]);
             path.push_back(p);
         }
         for (int i = 0; i < path.size(); i ++) 
             path[i]->size --;
-        p->value->~T(); Alloc::deallocate(p->value, 1); p->value = nullptr;
+        p->value->~T(); alloc.deallocate(p->value, 1); p->value = nullptr;
         if (p->size) return;
         for (int i = path.size() - 1; i >= 0; i --) {
             if (path[i]->size) { // 找到第一个有别的儿子的
-				delete path[i]->child[__trie_ctoi(s[i])];
+				deleteNode(path[i]->child[__trie_ctoi(s[i])]);
                 path[i]->child[__trie_ctoi(s[i])] = nullptr;
                 return;
             }
         }
 		// 都没有，根节点下面节点删了
-		delete path[0]->child[__trie_ctoi(s[0])];
+		deleteNode(path[0]->child[__trie_ctoi(s[0])]);
 		path[0]->child[__trie_ctoi(s[0])] = nullptr;
     }
 
@@ -336,7 +457,7 @@ namespace zyz {
             for (int i = 0; i < 63; i ++) {
                 if (p->child[i]) {
                     path += i + 'a';
-                    dfs(p->child[i]);
+                    dfs(std::to_address(p->child[i]));
                     path.pop_back();
                 }
             }
@@ -344,15 +465,16 @@ namespace zyz {
         dfs(root);
     }
 
-#include "stack.h"
     /**
      * @brief 做值为引用的键值对（遍历支持类似于 map 的结构化绑定）
      * 
      * @tparam T value类型
+     * @details 默认按字典树遍历的顺序（同一层按 a-z、A-Z、0-9 排），byteOrder 为真时再用 MSD 基数排序按键的字节序排一遍
+     * @param byteOrder 是否按键的字节序排列
      * @return std::vector<std::pair<std::string, T &>> 一个集合，内部键值对中键为常量访问，值为引用访问，支持操作
      */
     template <class T, typename Alloc> 
-    std::vector<std::pair<std::string, T &>> Trie<T, Alloc>::getKV() {
+    std::vector<std::pair<std::string, T &>> Trie<T, Alloc>::getKV(bool byteOrder) {
         std::vector<std::pair<std::string, T &>> ret;
         std::string path;
         std::function<void(TrieNode*)> dfs = [&](TrieNode* p) {
@@ -361,13 +483,47 @@ namespace zyz {
             for (int i = 0; i < 63; i ++) {
                 if (p->child[i]) {
                     path += __trie_itoc(i);
-                    dfs(p->child[i]);
+                    dfs(std::to_address(p->child[i]));
                     path.pop_back();
                 }
             }
         };
         dfs(root);
-        return ret;
+        if (!byteOrder)
+            return ret;
+        // 值是引用，键值对不能赋值，只能排好下标后重新构造
+        std::vector<size_t> order(ret.size());
+        for (size_t i = 0; i < order.size(); i ++)
+            order[i] = i;
+        zyz::radix_sort(order.begin(), order.end(), [&](size_t i) -> const std::string& { return ret[i].first; });
+        std::vector<std::pair<std::string, T &>> sorted;
+        sorted.reserve(ret.size());
+        for (size_t i : order)
+            sorted.emplace_back(std::move(ret[i].first), ret[i].second);
+        return sorted;
+    }
+
+    /**
+     * @brief 返回配置器实例
+     *
+     * @tparam T value类型
+     */
+    template <class T, typename Alloc>
+    typename Trie<T, Alloc>::allocator_type Trie<T, Alloc>::get_allocator() const {
+        return alloc;
+    }
+
+    /**
+     * @brief 路径数组超出内联容量时用的配置器
+     *
+     * @tparam T value类型
+     */
+    template <class T, typename Alloc>
+    typename Trie<T, Alloc>::PathAlloc Trie<T, Alloc>::pathAlloc() const {
+        if constexpr (std::is_pointer_v<ValuePtr>)
+            return PathAlloc(alloc);
+        else
+            return PathAlloc();
     }
 }
 
@@ -3,9 +3,26 @@
 
 #include "mempool.h"
 #include "allocator.h"
+#include <algorithm>
 #include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace zyz {
+	template<class T, typename Alloc>
+	class Vector;
+
+	// @brief 类型能否按字节搬家：把对象 memcpy 到新地址、不再析构旧对象，效果等同于 移动构造+析构
+	// 默认只有平凡可复制的类型可以；自己的类型满足时可以特化为 true
+	template<class T>
+	struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+	// zyz::Vector 只有三个指针和配置器，配置器可按字节复制时整个 Vector 也可以按字节搬家
+	template<class T, typename Alloc>
+	struct is_trivially_relocatable<Vector<T, Alloc>> : std::is_trivially_copyable<Alloc> {};
+
 	template<class T, typename Alloc = Allocator<T>>
 	class Vector {
 	public:
@@ -16,7 +33,8 @@ namespace zyz {
 		using const_reference =     const T &;
 		using size_type       =     size_t;
 		using difference_type =     ptrdiff_t;
-		using Self            =     Vector<T>;
+		using allocator_type  =     Alloc;
+		using Self            =     Vector<T, Alloc>;
 		using iterator        =     pointer;
 		using const_iterator  =     const_pointer;
 
@@ -27,15 +45,24 @@ namespace zyz {
 	public:
 		Vector();
 
-		Vector(int n, const T &data);
+		explicit Vector(const Alloc &alloc);
+
+		Vector(int n, const T &data, const Alloc &alloc = Alloc());
 
 		explicit Vector(const Self &v);
 
-		template<class Iterator>
-		Vector(Iterator first, Iterator last);
+		Vector(Self &&v) noexcept;
+
+		template<std::input_iterator Iterator>
+		Vector(Iterator first, Iterator last, const Alloc &alloc = Alloc());
 
 		~Vector();
 
+		Self& operator=(const Self &v);
+
+		Self& operator=(Self &&v) noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value
+		                                   || std::allocator_traits<Alloc>::is_always_equal::value);
+
 	public:
 		reference operator[](int i);
 
@@ -52,6 +79,21 @@ namespace zyz {
 
 		iterator insert(iterator pos, const T &data);
 
+		template<std::input_iterator Iterator>
+		iterator insert(iterator pos, Iterator first, Iterator last);
+
+		template<std::input_iterator Iterator>
+		void append(Iterator first, Iterator last);
+
+		template<std::input_iterator Iterator>
+		void assign(Iterator first, Iterator last);
+
+		void assign(size_type n, const T &data);
+
+		iterator erase(iterator pos);
+
+		iterator erase(iterator first, iterator last);
+
 		void push_back(const T &data);
 
 		void push_back(T &&data);
@@ -67,7 +109,36 @@ namespace zyz {
 
 		void clear();
 
-	private:
+		[[nodiscard]] allocator_type get_allocator() const noexcept;
+
+	protected:
+		using AllocTraits = std::allocator_traits<Alloc>;
+
+		void relocate(pointer first, pointer last, pointer dest);
+
+		void moveStorage(pointer pos, pointer newPlace, size_type gap);
+
+		void destroy(pointer first, pointer last);
+
+		bool expandInPlace(size_type n);
+
+		size_type growCapacity() const;
+
+		template<class ...Args>
+		iterator reallocInsert(iterator pos, Args &&... args);
+
+		template<class Iterator>
+		void constructRange(Iterator first, Iterator last, pointer dest);
+
+		iterator openGap(iterator pos, size_type n);
+
+		void closeGap(iterator pos, size_type n);
+
+		void takeStorage(Self &v) noexcept;
+
+		void release();
+
+		Alloc   _alloc;        ///< 配置器实例（决定使用哪个内存池）
 		pointer _start;        ///< 开始
 		pointer _finish;        ///< 结束（多一位）
 		pointer _endOfStorage;    ///< 可存结尾
@@ -92,50 +163,114 @@ zyz::Vector<T, Alloc>::Vector() :
 {}
 
 template<class T, typename Alloc>
-zyz::Vector<T, Alloc>::Vector(int n, const T &data):
-	_start(Alloc::allocate(n)),
-	_finish(_start + n),
+zyz::Vector<T, Alloc>::Vector(const Alloc &alloc) :
+		_alloc(alloc),
+		_start(nullptr),
+		_finish(nullptr),
+		_endOfStorage(nullptr)
+{}
+
+template<class T, typename Alloc>
+zyz::Vector<T, Alloc>::Vector(int n, const T &data, const Alloc &alloc):
+	_alloc(alloc),
+	_start(n > 0 ? _alloc.allocate(n) : nullptr),
+	_finish(_start),
 	_endOfStorage(_start + n)
 {
-	for (int i = 0; i < n; i ++) {
-		_start[i] = data;
+	while (_finish != _endOfStorage) {
+		AllocTraits::construct(_alloc, _finish, data);
+		_finish ++;
 	}
 }
 
 template<class T, typename Alloc>
-zyz::Vector<T, Alloc>::Vector(const Vector::Self &v)
+zyz::Vector<T, Alloc>::Vector(const Vector::Self &v) :
+	_alloc(AllocTraits::select_on_container_copy_construction(v._alloc))
 {
-	_start = _finish = Alloc::allocate(v.size());
+	_start = _finish = v.empty() ? nullptr : _alloc.allocate(v.size());
 	_endOfStorage = _start + v.size();
 	iterator it = v.begin();
 	while (_finish != _endOfStorage) {
-		*_finish = *it;
+		AllocTraits::construct(_alloc, _finish, *it);
 		it ++;
 		_finish ++;
 	}
 }
 
+// @brief 移动构造：直接接管 v 的缓冲区，不配置内存也不碰元素
 template<class T, typename Alloc>
-template<class Iterator>
-zyz::Vector<T, Alloc>::Vector(Iterator first, Iterator last) {
-	int count = 0;
-	auto it = first;
-	while (it != last) {
-		count ++;
-		it ++;
+zyz::Vector<T, Alloc>::Vector(Vector::Self &&v) noexcept :
+	_alloc(std::move(v._alloc)),
+	_start(v._start),
+	_finish(v._finish),
+	_endOfStorage(v._endOfStorage)
+{
+	v._start = v._finish = v._endOfStorage = nullptr;
+}
+
+// @brief 前向迭代器只数一遍长度（随机访问迭代器直接相减），一次配置到位
+template<class T, typename Alloc>
+template<std::input_iterator Iterator>
+zyz::Vector<T, Alloc>::Vector(Iterator first, Iterator last, const Alloc &alloc) :
+	_alloc(alloc),
+	_start(nullptr),
+	_finish(nullptr),
+	_endOfStorage(nullptr)
+{
+	append(first, last);
+}
+
+template<class T, typename Alloc>
+zyz::Vector<T, Alloc>::~Vector() {
+	release();
+}
+
+template<class T, typename Alloc>
+typename zyz::Vector<T, Alloc>::Self& zyz::Vector<T, Alloc>::operator=(const Vector::Self &v) {
+	if (this == &v)
+		return *this;
+	if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+		// 换配置器前先用旧配置器归还旧缓冲区
+		if (_alloc != v._alloc) {
+			release();
+			_alloc = v._alloc;
+		}
 	}
-	_start = _finish = Alloc::allocate(count);
-	_endOfStorage = _start + count;
-	while (_finish != _endOfStorage) {
-		*_finish = *first;
-		first ++;
+	clear();
+	reserve(v.size());
+	for (iterator it = v.begin(); it != v.end(); it ++) {
+		AllocTraits::construct(_alloc, _finish, *it);
 		_finish ++;
 	}
+	return *this;
 }
 
+// @brief 移动赋值：配置器随之传播或两边相等时直接接管缓冲区
+//     否则 v 的内存不能由本配置器归还，只能逐个移动元素
 template<class T, typename Alloc>
-zyz::Vector<T, Alloc>::~Vector() {
-	clear();
+typename zyz::Vector<T, Alloc>::Self& zyz::Vector<T, Alloc>::operator=(Vector::Self &&v)
+		noexcept(AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+	if (this == &v)
+		return *this;
+	if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+		release();
+		_alloc = std::move(v._alloc);
+		takeStorage(v);
+	} else {
+		if (AllocTraits::is_always_equal::value || _alloc == v._alloc) {
+			release();
+			takeStorage(v);
+		} else {
+			clear();
+			reserve(v.size());
+			for (iterator it = v.begin(); it != v.end(); it ++) {
+				AllocTraits::construct(_alloc, _finish, std::move(*it));
+				_finish ++;
+			}
+			v.clear();
+		}
+	}
+	return *this;
 }
 
 template<class T, typename Alloc>
@@ -160,13 +295,20 @@ bool zyz::Vector<T, Alloc>::empty() const noexcept {
 
 template<class T, typename Alloc>
 void zyz::Vector<T, Alloc>::reserve(Vector::size_type n) {
-	if (_start && n <= capacity())
+	if (n <= capacity())
+		return;
+	if (expandInPlace(n))
 		return;
 	size_type oldSize = size();
-	pointer newPlace = Alloc::allocate(n);
-	memcpy(newPlace, _start, sizeof(T) * oldSize);
+	pointer newPlace = _alloc.allocate(n);
+	try {
+		moveStorage(_finish, newPlace, 0);
+	} catch (...) {
+		_alloc.deallocate(newPlace, n);
+		throw;
+	}
 	if (_start) {
-		Alloc::deallocate(_start, oldSize);
+		_alloc.deallocate(_start, capacity());
 	}
 	_start = newPlace;
 	_finish = _start + oldSize;
@@ -175,75 +317,193 @@ void zyz::Vector<T, Alloc>::reserve(Vector::size_type n) {
 
 template<class T, typename Alloc>
 void zyz::Vector<T, Alloc>::resize(Vector::size_type newSize, const T &data) {
-	reserve(newSize);
-	size_type addSize = newSize - size();
-	for (int i = 0; i < addSize; i ++) {
-		*_finish = data;
+	if (newSize <= size()) {
+		destroy(_start + newSize, _finish);
+		_finish = _start + newSize;
+		return;
+	}
+	if (newSize > capacity()) {
+		// data 可能就是本容器中的元素，先复制一份再换缓冲区
+		T value(data);
+		reserve(newSize);
+		while (size() < newSize) {
+			AllocTraits::construct(_alloc, _finish, value);
+			_finish ++;
+		}
+		return;
+	}
+	while (size() < newSize) {
+		AllocTraits::construct(_alloc, _finish, data);
 		_finish ++;
 	}
 }
 
 template<class T, typename Alloc>
 typename zyz::Vector<T, Alloc>::iterator zyz::Vector<T, Alloc>::insert(Vector::iterator pos, const T &data) {
-	if (_start == nullptr) {
-		push_back(data);
-		return nullptr;
+	if (_finish == _endOfStorage && !expandInPlace(growCapacity())) {
+		return reallocInsert(pos, data);
 	}
-	if (_finish == _endOfStorage) {
-		reserve(capacity() * 2);
+	if (pos == _finish) {
+		AllocTraits::construct(_alloc, _finish, data);
+		_finish ++;
+		return pos;
 	}
-	iterator it = _finish;
-	while (true) {
-		*it = *(it - 1);
-		it --;
-		if (it == pos) break;
+	// data 可能指向要后移的元素，先复制一份
+	T value(data);
+	pos = openGap(pos, 1);
+	try {
+		AllocTraits::construct(_alloc, pos, std::move(value));
+	} catch (...) {
+		closeGap(pos, 1);
+		throw;
 	}
-	*it = data;
-	_finish ++;
 	return pos;
 }
 
+// @brief 在 pos 处插入 [first, last)，返回第一个插入元素的位置
+//     前向迭代器：先数出个数，容量不够时只配置一次，新元素直接构造到新缓冲区里，尾部整段搬一次
+//     单趟的输入迭代器：先读进临时容器，再按前向迭代器的方式移动进来
+//     新元素构造出异常时空位重新合上，容器恢复插入前的元素（容量可能已变大）
+//     与 std::vector 相同，[first, last) 不能是本容器中的元素
 template<class T, typename Alloc>
-void zyz::Vector<T, Alloc>::push_back(const T &data) {
-	if (_start == nullptr) {
-		_start = Alloc::allocate(1);
-		_finish = _start;
-		_endOfStorage = _start + 1;
-	} else if (_finish == _endOfStorage) {
-		reserve(size() * 2);
+template<std::input_iterator Iterator>
+typename zyz::Vector<T, Alloc>::iterator zyz::Vector<T, Alloc>::insert(Vector::iterator pos, Iterator first, Iterator last) {
+	size_type index = pos - _start;
+	if constexpr (std::forward_iterator<Iterator>) {
+		size_type n = std::distance(first, last);
+		if (n == 0)
+			return pos;
+		pos = openGap(pos, n);
+		try {
+			constructRange(first, last, pos);
+		} catch (...) {
+			closeGap(pos, n);
+			throw;
+		}
+	} else {
+		// 只能读一遍，先读进临时容器数出个数，再整段移动进来
+		Self buffer(_alloc);
+		for (; first != last; first ++)
+			buffer.emplace_back(*first);
+		if (buffer.empty())
+			return pos;
+		pointer dest = openGap(pos, buffer.size());
+		try {
+			relocate(buffer._start, buffer._finish, dest);
+		} catch (...) {
+			closeGap(dest, buffer.size());
+			throw;
+		}
 	}
-	*_finish = data;
-	_finish ++;
+	return _start + index;
 }
+
+// @brief 在末尾追加 [first, last)
 template<class T, typename Alloc>
-void zyz::Vector<T, Alloc>::push_back(T&& data) {
-	if (_start == nullptr) {
-		_start = Alloc::allocate(1);
-		_finish = _start;
-		_endOfStorage = _start + 1;
-	} else if (_finish == _endOfStorage) {
-		reserve(size() * 2);
+template<std::input_iterator Iterator>
+void zyz::Vector<T, Alloc>::append(Iterator first, Iterator last) {
+	insert(_finish, first, last);
+}
+
+// @brief 换成 [first, last) 的内容
+//     前向迭代器：容量不够时直接按需重新配置，旧元素不用搬；否则先赋值给已有元素（复用它们持有的资源），多出的构造、剩下的析构
+template<class T, typename Alloc>
+template<std::input_iterator Iterator>
+void zyz::Vector<T, Alloc>::assign(Iterator first, Iterator last) {
+	if constexpr (std::forward_iterator<Iterator>) {
+		size_type n = std::distance(first, last);
+		if (n > capacity()) {
+			release();
+			reserve(n);
+		}
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			// 赋值与构造没有区别，直接整段覆盖（连续存放时一次 memcpy）
+			constructRange(first, last, _start);
+			_finish = _start + n;
+			return;
+		}
+		pointer p = _start;
+		for (; first != last && p != _finish; first ++, p ++)
+			*p = *first;
+		if (p != _finish) {
+			destroy(p, _finish);
+			_finish = p;
+			return;
+		}
+		append(first, last);
+	} else {
+		clear();
+		append(first, last);
 	}
-	*_finish = std::forward<T>(data);
-	_finish ++;
+}
+
+template<class T, typename Alloc>
+void zyz::Vector<T, Alloc>::assign(Vector::size_type n, const T &data) {
+	if (n > capacity()) {
+		// data 可能就是本容器中的元素，先复制一份再归还旧缓冲区
+		T value(data);
+		release();
+		reserve(n);
+		for (; n; n --) {
+			AllocTraits::construct(_alloc, _finish, value);
+			_finish ++;
+		}
+		return;
+	}
+	size_type common = std::min(n, size());
+	// 容量够时元素都还在原地，data 引用的元素在被赋值前后值不变
+	std::fill(_start, _start + common, data);
+	if (n < size()) {
+		destroy(_start + n, _finish);
+		_finish = _start + n;
+		return;
+	}
+	for (; size() < n; ) {
+		AllocTraits::construct(_alloc, _finish, data);
+		_finish ++;
+	}
+}
+
+template<class T, typename Alloc>
+typename zyz::Vector<T, Alloc>::iterator zyz::Vector<T, Alloc>::erase(Vector::iterator pos) {
+	return erase(pos, pos + 1);
+}
+
+// @brief 删除 [first, last)：析构后把尾部整段前移，返回被删除段之后第一个元素的新位置
+template<class T, typename Alloc>
+typename zyz::Vector<T, Alloc>::iterator zyz::Vector<T, Alloc>::erase(Vector::iterator first, Vector::iterator last) {
+	if (first == last)
+		return first;
+	destroy(first, last);
+	closeGap(first, last - first);
+	return first;
+}
+
+template<class T, typename Alloc>
+void zyz::Vector<T, Alloc>::push_back(const T &data) {
+	emplace_back(data);
+}
+
+template<class T, typename Alloc>
+void zyz::Vector<T, Alloc>::push_back(T&& data) {
+	emplace_back(std::move(data));
 }
 
 template<class T, typename Alloc>
 template<class ...Args>
 void zyz::Vector<T, Alloc>::emplace_back(Args&&... args) {
-	if (_start == nullptr) {
-		_start = Alloc::allocate(1);
-		_finish = _start;
-		_endOfStorage = _start + 1;
-	} else if (_finish == _endOfStorage) {
-		reserve(size() * 2);
+	if (_finish == _endOfStorage && !expandInPlace(growCapacity())) {
+		reallocInsert(_finish, std::forward<Args>(args)...);
+		return;
 	}
-	Alloc::construct(_finish ++, std::forward<Args>(args)...);
+	AllocTraits::construct(_alloc, _finish, std::forward<Args>(args)...);
+	_finish ++;
 }
 
 template<class T, typename Alloc>
 void zyz::Vector<T, Alloc>::pop_back() {
 	_finish --;
+	AllocTraits::destroy(_alloc, _finish);
 }
 
 template<class T, typename Alloc>
@@ -256,11 +516,223 @@ T& zyz::Vector<T, Alloc>::back() noexcept {
 	return *(_finish - 1);
 }
 
+// @brief 析构所有元素，保留缓冲区
 template<class T, typename Alloc>
 void zyz::Vector<T, Alloc>::clear() {
+	destroy(_start, _finish);
+	_finish = _start;
+}
+
+template<class T, typename Alloc>
+typename zyz::Vector<T, Alloc>::allocator_type zyz::Vector<T, Alloc>::get_allocator() const noexcept {
+	return _alloc;
+}
+
+// @brief 把 [first, last) 构造到不重叠的 dest 处：移动构造，移动可能抛异常时复制
+//     出异常时析构 dest 处已构造的部分再抛出，旧元素保持原样；旧元素由调用者在全部成功后析构
+template<class T, typename Alloc>
+void zyz::Vector<T, Alloc>::relocate(Vector::pointer first, Vector::pointer last, Vector::pointer dest) {
+	pointer cur = dest;
+	try {
+		for (; first != last; first ++, cur ++)
+			AllocTraits::construct(_alloc, cur, std::move_if_noexcept(*first));
+	} catch (...) {
+		destroy(dest, cur);
+		throw;
+	}
+}
+
+// @brief 把所有元素搬到新缓冲区 newPlace：[_start, pos) 放在开头，[pos, _finish) 往后空出 gap 个位置
+//     可按字节搬家的类型直接 memcpy；否则先全部构造到新缓冲区，都成功了才析构旧元素
+//     出异常时新缓冲区里构造过的都已析构、旧元素原样保留，新缓冲区由调用者归还
+template<class T, typename Alloc>
+void zyz::Vector<T, Alloc>::moveStorage(Vector::pointer pos, Vector::pointer newPlace, Vector::size_type gap) {
+	size_type index = pos - _start;
+	if constexpr (is_trivially_relocatable<T>::value) {
+		if (index)
+			memcpy((void *)newPlace, (const void *)_start, sizeof(T) * index);
+		if (pos != _finish)
+			memcpy((void *)(newPlace + index + gap), (const void *)pos, sizeof(T) * (_finish - pos));
+	} else {
+		relocate(_start, pos, newPlace);
+		try {
+			relocate(pos, _finish, newPlace + index + gap);
+		} catch (...) {
+			destroy(newPlace, newPlace + index);
+			throw;
+		}
+		destroy(_start, _finish);
+	}
+}
+
+template<class T, typename Alloc>
+void zyz::Vector<T, Alloc>::destroy(Vector::pointer first, Vector::pointer last) {
+	if constexpr (!std::is_trivially_destructible_v<T>) {
+		for (; first != last; first ++)
+			AllocTraits::destroy(_alloc, first);
+	}
+}
+
+// @brief 配置器支持原地扩展时先试一下，成功就不用搬数据
+template<class T, typename Alloc>
+bool zyz::Vector<T, Alloc>::expandInPlace(Vector::size_type n) {
+	if constexpr (requires { _alloc.tryExpand(_start, n, n); }) {
+		if (_start && _alloc.tryExpand(_start, capacity(), n)) {
+			_endOfStorage = _start + n;
+			return true;
+		}
+	}
+	return false;
+}
+
+// @brief 缓冲区满时扩容到的大小：容量倍增，至少为 1（容量为 0 的缓冲区倍增后仍是 0）
+template<class T, typename Alloc>
+typename zyz::Vector<T, Alloc>::size_type zyz::Vector<T, Alloc>::growCapacity() const {
+	return std::max<size_type>(1, capacity() * 2);
+}
+
+// @brief 缓冲区已满时在 pos 处插入：先在新缓冲区里构造新元素，再把 pos 前后两段搬过去
+//     args 可能引用旧缓冲区中的元素，所以必须在搬家之前构造
+template<class T, typename Alloc>
+template<class ...Args>
+typename zyz::Vector<T, Alloc>::iterator zyz::Vector<T, Alloc>::reallocInsert(Vector::iterator pos, Args&&... args) {
+	size_type n = growCapacity();
+	size_type index = pos - _start;
+	size_type oldSize = size();
+	pointer newPlace = _alloc.allocate(n);
+	try {
+		AllocTraits::construct(_alloc, newPlace + index, std::forward<Args>(args)...);
+	} catch (...) {
+		_alloc.deallocate(newPlace, n);
+		throw;
+	}
+	try {
+		moveStorage(pos, newPlace, 1);
+	} catch (...) {
+		AllocTraits::destroy(_alloc, newPlace + index);
+		_alloc.deallocate(newPlace, n);
+		throw;
+	}
+	if (_start) {
+		_alloc.deallocate(_start, capacity());
+	}
+	_start = newPlace;
+	_finish = _start + oldSize + 1;
+	_endOfStorage = _start + n;
+	return _start + index;
+}
+
+// @brief 把 [first, last) 复制构造到未构造的 dest 处
+//     连续存放的同类型元素且可按字节复制时一次 memcpy
+//     出异常时析构 dest 处已构造的部分再抛出
+template<class T, typename Alloc>
+template<class Iterator>
+void zyz::Vector<T, Alloc>::constructRange(Iterator first, Iterator last, Vector::pointer dest) {
+	if constexpr (std::contiguous_iterator<Iterator> && std::is_trivially_copyable_v<T>
+	              && std::is_same_v<std::iter_value_t<Iterator>, T>) {
+		if (first != last)
+			memcpy((void *)dest, (const void *)std::to_address(first), sizeof(T) * (last - first));
+	} else {
+		pointer cur = dest;
+		try {
+			for (; first != last; first ++, cur ++)
+				AllocTraits::construct(_alloc, cur, *first);
+		} catch (...) {
+			destroy(dest, cur);
+			throw;
+		}
+	}
+}
+
+// @brief 在 pos 处空出 n 个未构造的位置，size 随之加 n，返回空位的开头
+//     容量不够时按 max(2 倍容量, 所需大小) 只配置一次，前后两段分别搬到新缓冲区
+//     容量够时尾部整段后移：可按字节搬家的类型一次 memmove，否则从后往前 移动构造+析构
+//     后移中途出异常时把已后移的元素移回原处，容器保持原样；移回时再出异常则丢掉尾部没移回的元素
+template<class T, typename Alloc>
+typename zyz::Vector<T, Alloc>::iterator zyz::Vector<T, Alloc>::openGap(Vector::iterator pos, Vector::size_type n) {
+	size_type index = pos - _start;
+	size_type oldSize = size();
+	if (oldSize + n > capacity()) {
+		size_type newCap = std::max(capacity() * 2, oldSize + n);
+		if (!expandInPlace(newCap)) {
+			pointer newPlace = _alloc.allocate(newCap);
+			try {
+				moveStorage(pos, newPlace, n);
+			} catch (...) {
+				_alloc.deallocate(newPlace, newCap);
+				throw;
+			}
+			if (_start) {
+				_alloc.deallocate(_start, capacity());
+			}
+			_start = newPlace;
+			_finish = _start + oldSize + n;
+			_endOfStorage = _start + newCap;
+			return _start + index;
+		}
+		pos = _start + index;
+	}
+	if constexpr (is_trivially_relocatable<T>::value) {
+		if (pos != _finish)
+			memmove((void *)(pos + n), (const void *)pos, sizeof(T) * (_finish - pos));
+	} else {
+		pointer src = _finish;
+		try {
+			while (src != pos) {
+				AllocTraits::construct(_alloc, src - 1 + n, std::move(*(src - 1)));
+				AllocTraits::destroy(_alloc, src - 1);
+				src --;
+			}
+		} catch (...) {
+			try {
+				for (; src != _finish; src ++) {
+					AllocTraits::construct(_alloc, src, std::move(*(src + n)));
+					AllocTraits::destroy(_alloc, src + n);
+				}
+			} catch (...) {
+				// 移回也出异常：丢掉还没移回的元素，只保留 [_start, src)
+				destroy(src + n, _finish + n);
+				_finish = src;
+				throw;
+			}
+			throw;
+		}
+	}
+	_finish += n;
+	return pos;
+}
+
+// @brief 把 [pos + n, _finish) 前移 n 位填上已析构的 [pos, pos + n)，size 随之减 n
+template<class T, typename Alloc>
+void zyz::Vector<T, Alloc>::closeGap(Vector::iterator pos, Vector::size_type n) {
+	if constexpr (is_trivially_relocatable<T>::value) {
+		if (pos + n != _finish)
+			memmove((void *)pos, (const void *)(pos + n), sizeof(T) * (_finish - pos - n));
+	} else {
+		for (pointer src = pos + n; src != _finish; src ++) {
+			AllocTraits::construct(_alloc, src - n, std::move(*src));
+			AllocTraits::destroy(_alloc, src);
+		}
+	}
+	_finish -= n;
+}
+
+// @brief 接管 v 的缓冲区（调用前本容器必须为空且已归还缓冲区）
+template<class T, typename Alloc>
+void zyz::Vector<T, Alloc>::takeStorage(Vector::Self &v) noexcept {
+	_start = v._start;
+	_finish = v._finish;
+	_endOfStorage = v._endOfStorage;
+	v._start = v._finish = v._endOfStorage = nullptr;
+}
+
+// @brief 析构所有元素并归还缓冲区
+template<class T, typename Alloc>
+void zyz::Vector<T, Alloc>::release() {
 	if (_start == nullptr)
 		return;
-	Alloc::deallocate(_start, capacity());
+	destroy(_start, _finish);
+	_alloc.deallocate(_start, capacity());
 	_start = _finish = _endOfStorage = nullptr;
 }
 
@@ -2,24 +2,40 @@
 #define _ALLOCATOR_H_
 
 #include "mempool.h"
+#include "mempool_policy.h"
 #include <iostream>
 #include <climits>
+#include <memory>
+#include <new>
+#include <type_traits>
 
 extern MemPool *mem_pool;
 
 namespace zyz {
 
 	template<class T>
-	inline T *_allocate(ptrdiff_t size, T *) {
-		return reinterpret_cast<T *>(mem_pool->allocate(std::max(size, (ptrdiff_t)sizeof(MemListNode))));
+	inline T *_allocate(::MemPool *pool, ptrdiff_t size, size_t alignment, T *) {
+		return reinterpret_cast<T *>(ThreadCache::local(pool)->allocate(std::max(size, (ptrdiff_t)sizeof(MemListNode)), (ssize_t)alignment));
 	}
 
 	template<class T>
-	inline void _deallocate(T *buffer, size_t n) {
-		mem_pool->deallocate((uint8_t *) buffer, std::max(n * sizeof(T), (size_t)sizeof(MemListNode)));
+	inline void _deallocate(::MemPool *pool, T *buffer, size_t n, size_t alignment) {
+		ThreadCache::local(pool)->deallocate(buffer, std::max(n * sizeof(T), (size_t)sizeof(MemListNode)), (ssize_t)alignment);
 	}
 
-	template<class T>
+	// @brief Allocator<T, Pool> 默认构造时绑定的 Pool 实例，使用前由用户设置
+	// ::MemPool 默认绑定全局的 mem_pool
+	template<class Pool>
+	inline Pool* defaultPool = nullptr;
+
+	// @brief 绑定到某个内存池实例的配置器
+	// 只保存一个内存池指针，指向同一个内存池的配置器相等，可以互相释放对方配置的内存
+	// 默认构造的配置器保存空指针，每次配置时才去读全局的内存池：全局变量的构造顺序不定，构造配置器时 mem_pool 可能还没设置
+	// 容器 复制/移动/交换 时配置器随之传播，让每个子系统可以使用自己的内存池
+	// @tparam Pool 内存池类型
+	//     - ::MemPool:          运行期选算法的内存池，经过线程本地缓存
+	//     - zyz::MemPool<...>:  编译期选算法的内存池，配置路径可整个内联
+	template<class T, class Pool = ::MemPool>
 	class Allocator {
 	public:
 		using value_type = T;
@@ -29,18 +45,86 @@ namespace zyz {
 		using const_reference = const T &;
 		using size_type = size_t;
 		using difference_type = ptrdiff_t;
+		using pool_type = Pool;
+
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+		using is_always_equal = std::false_type;
 
 		template<class U>
 		struct rebind {
-			using other = Allocator<U>;
+			using other = Allocator<U, Pool>;
 		};
 
-		static pointer allocate(size_type n, const void *hint = nullptr) {
-			return _allocate((difference_type) (n * sizeof(T)), pointer(0));
+		Allocator() noexcept : pool(nullptr) {}
+
+		explicit Allocator(Pool *_pool) noexcept : pool(_pool) {}
+
+		template<class U>
+		Allocator(const Allocator<U, Pool> &that) noexcept : pool(that.pool) {}
+
+		// @brief 按 alignof(T) 对齐配置 n 个 T
+		pointer allocate(size_type n, const void * = nullptr) const {
+			return allocate(n, std::align_val_t(alignof(T)));
+		}
+
+		// @brief 按 alignment 对齐配置 n 个 T（可超过 alignof(T)，如按缓存行对齐）
+		pointer allocate(size_type n, std::align_val_t alignment) const {
+			auto align = std::max((size_t)alignment, alignof(T));
+			if constexpr (std::is_same_v<Pool, ::MemPool>)
+				return _allocate(getPool(), (difference_type) (n * sizeof(T)), align, pointer(0));
+			else
+				return reinterpret_cast<pointer>(getPool()->allocate(std::max(n * sizeof(T), sizeof(MemListNode)), (ssize_t)align));
 		}
 
-		static void deallocate(pointer p, size_type n) {
-			_deallocate(p, n);
+		void deallocate(pointer p, size_type n) const {
+			deallocate(p, n, std::align_val_t(alignof(T)));
+		}
+
+		// @brief 回收，alignment 与配置时一致
+		void deallocate(pointer p, size_type n, std::align_val_t alignment) const {
+			auto align = std::max((size_t)alignment, alignof(T));
+			if constexpr (std::is_same_v<Pool, ::MemPool>)
+				_deallocate(getPool(), p, n, align);
+			else
+				getPool()->deallocate(reinterpret_cast<uint8_t *>(p), std::max(n * sizeof(T), sizeof(MemListNode)));
+		}
+
+		// @brief 批量配置 count 份 n 个 T（按 alignof(T) 对齐），存入 out
+		// @return 实际配置到的份数，不足 count 时内存池已没有空间
+		size_type allocateBatch(size_type n, pointer *out, size_type count) const {
+			auto bytes = (ssize_t)std::max(n * sizeof(T), sizeof(MemListNode));
+			if constexpr (std::is_same_v<Pool, ::MemPool>) {
+				return (size_type)ThreadCache::local(getPool())->allocateBatch((int)count, bytes,
+						reinterpret_cast<void **>(out), (ssize_t)alignof(T));
+			} else {
+				size_type i = 0;
+				while (i < count && (out[i] = reinterpret_cast<pointer>(getPool()->allocate(bytes, (ssize_t)alignof(T)))) != nullptr)
+					i ++;
+				return i;
+			}
+		}
+
+		// @brief 批量回收 count 份 n 个 T
+		void deallocateBatch(pointer *ptrs, size_type n, size_type count) const {
+			auto bytes = (ssize_t)std::max(n * sizeof(T), sizeof(MemListNode));
+			if constexpr (std::is_same_v<Pool, ::MemPool>) {
+				ThreadCache::local(getPool())->deallocateBatch(reinterpret_cast<void **>(ptrs), (int)count, bytes, (ssize_t)alignof(T));
+			} else {
+				for (size_type i = 0; i < count; i ++)
+					getPool()->deallocate(reinterpret_cast<uint8_t *>(ptrs[i]), bytes);
+			}
+		}
+
+		// @brief 把 p 处 n 个 T 的空间原地调整为 newN 个，失败时不做任何修改
+		// 编译期内存池不支持，总是失败
+		bool tryExpand(pointer p, size_type n, size_type newN) const {
+			if constexpr (std::is_same_v<Pool, ::MemPool>)
+				return ThreadCache::local(getPool())->tryExpand(p, std::max(n * sizeof(T), sizeof(MemListNode)),
+						std::max(newN * sizeof(T), sizeof(MemListNode)), (ssize_t)alignof(T));
+			else
+				return false;
 		}
 
 		template<class ...Args>
@@ -48,8 +132,12 @@ namespace zyz {
 			new(p) T(std::forward<Args>(args)...);
 		}
 
+		static void destroy(pointer p) {
+			p->~T();
+		}
+
 		static void destory(pointer p) {
-			p->~U();
+			destroy(p);
 		}
 
 		static pointer address(reference x) {
@@ -63,8 +151,66 @@ namespace zyz {
 		[[nodiscard]] size_type max_size() const {
 			return size_type(UINT_MAX / sizeof(T));
 		}
+
+		// @brief 容器复制构造时沿用同一个内存池
+		Allocator select_on_container_copy_construction() const {
+			return *this;
+		}
+
+		// @brief 实际使用的内存池
+		[[nodiscard]] Pool *getPool() const noexcept {
+			if (pool)
+				return pool;
+			if constexpr (std::is_same_v<Pool, ::MemPool>)
+				return mem_pool;
+			else
+				return defaultPool<Pool>;
+		}
+
+	private:
+		template<class U, class P>
+		friend class Allocator;
+
+		Pool *pool;	///< 绑定的内存池，空指针表示全局默认的内存池
 	};
 
+	template<class T, class U, class Pool>
+	bool operator==(const Allocator<T, Pool> &a, const Allocator<U, Pool> &b) noexcept {
+		return a.getPool() == b.getPool();
+	}
+
+	template<class T, class U, class Pool>
+	bool operator!=(const Allocator<T, Pool> &a, const Allocator<U, Pool> &b) noexcept {
+		return a.getPool() != b.getPool();
+	}
+
+	// @brief 容器批量配置 count 份 n 个元素
+	// 配置器提供 allocateBatch 时走批量路径，否则逐个 allocate
+	// @return 实际配置到的份数
+	template<class Alloc>
+	size_t allocateBatch(Alloc &alloc, size_t n, typename std::allocator_traits<Alloc>::pointer *out, size_t count) {
+		if constexpr (requires { alloc.allocateBatch(n, out, count); }) {
+			return alloc.allocateBatch(n, out, count);
+		} else {
+			for (size_t i = 0; i < count; i ++)
+				if ((out[i] = alloc.allocate(n)) == nullptr)
+					return i;
+			return count;
+		}
+	}
+
+	// @brief 容器批量回收 count 份 n 个元素
+	// 配置器提供 deallocateBatch 时走批量路径，否则逐个 deallocate
+	template<class Alloc>
+	void deallocateBatch(Alloc &alloc, typename std::allocator_traits<Alloc>::pointer *ptrs, size_t n, size_t count) {
+		if constexpr (requires { alloc.deallocateBatch(ptrs, n, count); }) {
+			alloc.deallocateBatch(ptrs, n, count);
+		} else {
+			for (size_t i = 0; i < count; i ++)
+				alloc.deallocate(ptrs[i], n);
+		}
+	}
+
 }
 
 #endif
\ No newline at end of file
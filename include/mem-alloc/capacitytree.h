@@ -0,0 +1,36 @@
+#ifndef _CAPACITY_TREE_H_
+#define _CAPACITY_TREE_H_
+
+#include <cstdio>
+#include <set>
+#include <utility>
+
+// @brief 空闲链表容量树
+// 以线段树（大根）维护每张空闲链表的最大可用空间 maxSize
+// 单点更新、查找首个/最大/最贴合的可用链表均为 O(log n)
+class CapacityTree {
+public:
+    CapacityTree () = delete;
+    CapacityTree (ssize_t n, bool _trackBestFit);
+    ~CapacityTree ();
+
+    CapacityTree (const CapacityTree& that) = delete;
+    CapacityTree& operator = (const CapacityTree& that) = delete;
+
+    void    resize (ssize_t n);
+    void    update (int i, ssize_t capacity);
+    int     firstFit (ssize_t need, int from = 0) const;
+    int     worstFit (ssize_t need) const;
+    int     bestFit (ssize_t need) const;
+
+private:
+    int     firstFit (int node, int l, int r, ssize_t need, int from) const;
+
+    ssize_t   size;         ///< 叶子数量（链表数量）
+    ssize_t   leaves;       ///< 不小于 size 的 2 的幂次
+    ssize_t*  tree;         ///< tree[1] 为根，tree[leaves + i] 为第 i 张链表
+    bool      trackBestFit; ///< 是否额外维护按容量有序的集合（最佳适应用）
+    std::set<std::pair<ssize_t, int>> ordered; ///< (容量, 下标)
+};
+
+#endif
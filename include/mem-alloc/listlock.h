@@ -0,0 +1,38 @@
+#ifndef _LIST_LOCK_H_
+#define _LIST_LOCK_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// @brief 锁统计快照
+struct ListLockStats {
+    uint64_t acquisitions = 0;  ///< 成功加锁次数
+    uint64_t contentions  = 0;  ///< 加锁时锁已被占用的次数（try_lock 失败也算）
+    uint64_t holdNanos    = 0;  ///< 累计持有时间（纳秒）
+};
+
+// @brief 单张空闲链表的锁
+// 在 std::mutex 外统计加锁次数、竞争次数与持有时间，计数均为 relaxed 原子量
+class ListLock {
+public:
+    ListLock () = default;
+    ListLock (const ListLock& that) = delete;
+    ListLock& operator = (const ListLock& that) = delete;
+
+    void lock ();
+    bool try_lock ();
+    void unlock ();
+
+    [[nodiscard]] ListLockStats stats () const;
+
+private:
+    std::mutex                            mutex;
+    std::chrono::steady_clock::time_point lockedAt;     ///< 本次加锁时刻（仅持锁者读写）
+    std::atomic<uint64_t>                 acquisitions{0};
+    std::atomic<uint64_t>                 contentions{0};
+    std::atomic<uint64_t>                 holdNanos{0};
+};
+
+#endif
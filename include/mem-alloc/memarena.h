@@ -0,0 +1,171 @@
+#ifndef _MEM_ARENA_H_
+#define _MEM_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+class MemPool;
+
+// @brief 单调（只增不减）的区域分配器
+// 从内存池成块申请（默认 DEFAULT_BLOCK_SIZE），块内移动指针配置，单个对象不回收
+// 适合按请求构建、用完整体丢弃的数据：checkpoint/rewind 回到之前的位置，reset 清空，都是 O(1)
+// 回退与清空只移动指针，已申请的块留着给之后的配置复用，release 或析构时才还给内存池
+// 不加锁，同一时刻只能由一个线程使用
+class MemArena {
+public:
+    static constexpr ssize_t DEFAULT_BLOCK_SIZE = 64 << 10;             ///< 每次向内存池申请的块大小
+    static constexpr ssize_t DEFAULT_ALIGNMENT  = alignof(std::max_align_t);
+
+    // @brief 位置记录，由 checkpoint 得到，交给 rewind 回退
+    struct Checkpoint {
+        void*    block;  ///< 当时所在的块（nullptr 表示还没有配置过）
+        uint8_t* pos;    ///< 当时的配置位置
+    };
+
+    MemArena () = delete;
+    explicit MemArena (MemPool* _pool, ssize_t _blockSize = DEFAULT_BLOCK_SIZE);
+    ~MemArena ();
+
+    MemArena (const MemArena& that) = delete;
+    MemArena& operator = (const MemArena& that) = delete;
+
+    // @brief 内存配置：当前块放得下就只移动指针，否则换到下一块
+    // @parma alignment 对齐要求（2 的幂次）
+    // @return
+    //     - not nullptr: successfully
+    //     - nullptr:     内存池给不出新块
+    void* allocate (ssize_t size, ssize_t alignment = DEFAULT_ALIGNMENT) {
+        auto aligned = ((uintptr_t)pos + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        if (pos != nullptr && (ssize_t)(end - (uint8_t *)aligned) >= size) {
+            pos = (uint8_t *)aligned + size;
+            return (void *)aligned;
+        }
+        return allocateSlow(size, alignment);
+    }
+
+    bool    tryExpand (void* address, ssize_t oldSize, ssize_t newSize);
+
+    [[nodiscard]] Checkpoint checkpoint () const;
+    void    rewind (const Checkpoint& cp);
+    void    reset ();
+    void    release ();
+
+    [[nodiscard]] MemPool* getPool () const noexcept;
+    [[nodiscard]] ssize_t  getBlockSize () const noexcept;
+    [[nodiscard]] ssize_t  getReservedBytes () const noexcept;
+
+private:
+    // @brief 块头，块按申请顺序串成单链表
+    struct Block {
+        Block*   next;   ///< 下一块
+        ssize_t  bytes;  ///< 整块大小（含块头）
+
+        [[nodiscard]] uint8_t* begin () { return reinterpret_cast<uint8_t*>(this) + sizeof(Block); }
+        [[nodiscard]] uint8_t* end ()   { return reinterpret_cast<uint8_t*>(this) + bytes; }
+    };
+
+    void*   allocateSlow (ssize_t size, ssize_t alignment);
+
+    MemPool*  pool;           ///< 块的来源
+    ssize_t   blockSize;      ///< 普通块的大小
+    ssize_t   reservedBytes;  ///< 持有的块总大小
+    Block*    first;          ///< 第一块
+    Block*    current;        ///< 正在配置的块（nullptr 表示还没有配置过）
+    uint8_t*  pos;            ///< 当前块中下一次配置的位置
+    uint8_t*  end;            ///< 当前块的末尾
+};
+
+// @brief 作用域检查点：构造时记录位置，析构时回退，期间配置的内存一并作废
+class ArenaScope {
+public:
+    explicit ArenaScope (MemArena& _arena) : arena(_arena), cp(_arena.checkpoint()) {}
+    ~ArenaScope () { arena.rewind(cp); }
+
+    ArenaScope (const ArenaScope& that) = delete;
+    ArenaScope& operator = (const ArenaScope& that) = delete;
+
+private:
+    MemArena&             arena;
+    MemArena::Checkpoint  cp;
+};
+
+namespace zyz {
+
+	// @brief 从 MemArena 配置的配置器
+	// deallocate 什么都不做，内存随 arena 的 rewind/reset 整体回收
+	// 指向同一个 arena 的配置器相等，容器 复制/移动/交换 时随之传播
+	template<class T>
+	class ArenaAllocator {
+	public:
+		using value_type = T;
+		using pointer = T *;
+		using const_pointer = const T *;
+		using reference = T &;
+		using const_reference = const T &;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+		using is_always_equal = std::false_type;
+
+		template<class U>
+		struct rebind {
+			using other = ArenaAllocator<U>;
+		};
+
+		explicit ArenaAllocator(MemArena *_arena) noexcept : arena(_arena) {}
+
+		template<class U>
+		ArenaAllocator(const ArenaAllocator<U> &that) noexcept : arena(that.getArena()) {}
+
+		pointer allocate(size_type n, const void * = nullptr) const {
+			return reinterpret_cast<pointer>(arena->allocate((ssize_t)(n * sizeof(T)), (ssize_t)alignof(T)));
+		}
+
+		void deallocate(pointer, size_type) const noexcept {}
+
+		// @brief 最近一次配置的块可以原地伸缩
+		bool tryExpand(pointer p, size_type n, size_type newN) const {
+			return arena->tryExpand(p, (ssize_t)(n * sizeof(T)), (ssize_t)(newN * sizeof(T)));
+		}
+
+		template<class ...Args>
+		static void construct(pointer p, Args&& ...args) {
+			new(p) T(std::forward<Args>(args)...);
+		}
+
+		static void destroy(pointer p) {
+			p->~T();
+		}
+
+		ArenaAllocator select_on_container_copy_construction() const {
+			return *this;
+		}
+
+		[[nodiscard]] MemArena *getArena() const noexcept {
+			return arena;
+		}
+
+	private:
+		MemArena *arena;	///< 绑定的 arena
+	};
+
+	template<class T, class U>
+	bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) noexcept {
+		return a.getArena() == b.getArena();
+	}
+
+	template<class T, class U>
+	bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) noexcept {
+		return a.getArena() != b.getArena();
+	}
+
+}
+
+#endif
@@ -2,10 +2,14 @@
 #define _MEMLIST_H_
 
 #include "memlistnode.h"
+#include "listlock.h"
+#include "memstats.h"
 
 #include <cstdio>
 #include <cstdint>
+#include <atomic>
 #include <set>
+#include <utility>
 
 // @brief 空闲内存链表
 // 内存从 MemList 中申请(new)，归还(delete)时释放回先前申请的 MemList 中
@@ -15,17 +19,35 @@ public:
     MemList (void* pos, ssize_t size);
     virtual ~MemList ();
 
-	void print () const;
-    void deallocate (uint8_t *address, ssize_t size);
+	virtual void print () const;
+    virtual void deallocate (uint8_t *address, ssize_t size);
+    virtual void deallocateSorted (const std::pair<uint8_t*, ssize_t> *blocks, int count);
+    virtual bool tryExpand (uint8_t *address, ssize_t oldSize, ssize_t newSize);
     void resetMaxSize ();
 
+    virtual void  reset ();
+    [[nodiscard]] virtual bool isFree () const;
+    virtual void  freeStats (MemListStats &stats) const;
+
+    void pushPending (uint8_t *address, ssize_t size);
+    bool drainPending ();
+    [[nodiscard]] bool hasPending () const;
+
     virtual void* allocate (ssize_t size) = 0;
+    virtual void* allocateAligned (ssize_t size, ssize_t alignment) = 0;
+
+protected:
+    void* carve (MemListNode *p, uint8_t *at, ssize_t size);
+    MemListNode* insertFrom (MemListNode *p, uint8_t *address, ssize_t size);
 
 public:
-    MemListNode* head;       	///< 头结点（含信息）
+    MemListNode* head;       	///< 头结点（含信息，不使用单链表的派生类为 nullptr）
     ssize_t      maxSize;    	///< 可用最大空间链表节点
     void*        beginPos;   	///< 管理块的首地址
     ssize_t      beginSize;  	///< 申请时使用的空间
+    ListLock     lock;          ///< 保护本链表的锁
+    MemCounters  counters;      ///< 本链表的配置/回收计数
+    std::atomic<MemListNode*> pending{nullptr};  ///< 待归还栈：锁被占用时的归还先无锁压入，持锁者批量合并
 
 friend class MemPool;
 };
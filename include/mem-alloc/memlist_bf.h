@@ -11,6 +11,7 @@ public:
     ~MemList_BF() override = default;
 
     void* allocate (ssize_t size) override;
+    void* allocateAligned (ssize_t size, ssize_t alignment) override;
 };
 
 #endif
\ No newline at end of file
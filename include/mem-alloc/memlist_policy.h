@@ -0,0 +1,188 @@
+#ifndef _MEMLIST_POLICY_H_
+#define _MEMLIST_POLICY_H_
+
+#include "memlistnode.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <new>
+
+namespace zyz {
+
+    // @brief 节点 p 能否切出 size（剩余空间还要能保存一个空闲节点）
+    inline bool fitsNode (const MemListNode *p, ssize_t size) {
+        return p->getSize() >= size && p->getSize() - size >= (ssize_t)sizeof(MemListNode);
+    }
+
+    // @brief 在节点 p 的尾部找一个按 alignment 对齐、放得下 size 的位置
+    // 前面剩下的部分仍是节点 p（至少能保存一个空闲节点）
+    // 后面剩下的部分要么为 0，要么也能保存一个空闲节点
+    // @parma alignment 2 的幂次
+    // @return 对齐位置，放不下为 nullptr
+    inline uint8_t* alignedSpot (const MemListNode *p, ssize_t size, ssize_t alignment) {
+        const auto node = (ssize_t)sizeof(MemListNode);
+        if (p->getSize() < size + node)
+            return nullptr;
+        auto begin = reinterpret_cast<uintptr_t>(p);
+        auto end = begin + p->getSize();
+        uintptr_t at = (end - size) & ~(uintptr_t)(alignment - 1);
+        while (end - size - at != 0 && end - size - at < node) {
+            if (at < begin + node + alignment)
+                return nullptr;
+            at -= alignment;
+        }
+        return at >= begin + node ? reinterpret_cast<uint8_t*>(at) : nullptr;
+    }
+
+    // @brief 首次适应：第一个空间足够的节点
+    struct FirstFit {
+        static constexpr bool WIDEST_LIST = false;  ///< 内存池选链表时是否取容量最大的
+
+        // @parma fits 节点是否放得下
+        template<class Fits>
+        static MemListNode* select (MemListNode *head, Fits fits) {
+            for (MemListNode *p = head; p; p = p->next)
+                if (fits(p))
+                    return p;
+            return nullptr;
+        }
+    };
+
+    // @brief 最佳适应：空间足够的节点中最小的
+    struct BestFit {
+        static constexpr bool WIDEST_LIST = false;
+
+        template<class Fits>
+        static MemListNode* select (MemListNode *head, Fits fits) {
+            MemListNode *ret = nullptr;
+            for (MemListNode *p = head; p; p = p->next)
+                if (fits(p) && (!ret || p->getSize() < ret->getSize()))
+                    ret = p;
+            return ret;
+        }
+    };
+
+    // @brief 最坏适应：空间足够的节点中最大的
+    struct WorstFit {
+        static constexpr bool WIDEST_LIST = true;
+
+        template<class Fits>
+        static MemListNode* select (MemListNode *head, Fits fits) {
+            MemListNode *ret = nullptr;
+            for (MemListNode *p = head; p; p = p->next)
+                if (fits(p) && (!ret || p->getSize() > ret->getSize()))
+                    ret = p;
+            return ret;
+        }
+    };
+
+    // @brief 编译期选定分配算法的空闲链表
+    // 与 ::MemList 的单链表结构相同，但没有虚函数，allocate/deallocate 可以完全内联
+    // @tparam Policy 提供 static MemListNode* select(head, fits) 的分配算法
+    template<class Policy>
+    class MemList {
+    public:
+        MemList () = delete;
+        MemList (const MemList& that) = delete;
+        MemList& operator = (const MemList& that) = delete;
+
+        // @brief 构造函数
+        // @parma pos   内存块首地址（由内存池提供）
+        // @parma size  内存块大小
+        MemList (void* pos, ssize_t size) : maxSize(size), beginPos(pos), beginSize(size) {
+            head = reinterpret_cast<MemListNode*>(pos);
+            new(head) MemListNode(size, nullptr);
+        }
+
+        ~MemList () {
+            if (!isFree())
+                std::cout << "\033[33;1mWarning\033[0m: some memory still not reclaimed (in zyz::MemList destructors)" << std::endl;
+        }
+
+        // @brief 空间分配函数
+        // 从 Policy 选出的节点尾部切出 size，只有切的恰好是最大节点时才重新扫描 maxSize
+        // @return
+        //   - not nullptr:  分配到的首地址
+        //   - nullptr:      空间都不够分配
+        void* allocate (ssize_t size) {
+            MemListNode *p = Policy::select(head, [size](const MemListNode *q) { return fitsNode(q, size); });
+            if (p == nullptr)
+                return nullptr;
+            bool wasMax = p->size == maxSize;
+            p->size -= size;
+            if (wasMax)
+                resetMaxSize();
+            return (uint8_t *)p->getAddress() + p->size;
+        }
+
+        // @brief 按 alignment 对齐的空间分配
+        // 在 Policy 选出的节点尾部切出对齐的一段，后面剩余的部分成为新的空闲节点
+        void* allocateAligned (ssize_t size, ssize_t alignment) {
+            MemListNode *p = Policy::select(head, [size, alignment](const MemListNode *q) {
+                return alignedSpot(q, size, alignment) != nullptr;
+            });
+            if (p == nullptr)
+                return nullptr;
+            uint8_t *at = alignedSpot(p, size, alignment);
+            bool wasMax = p->size == maxSize;
+            ssize_t tail = (uint8_t *)p->getAddress() + p->size - (at + size);
+            p->size = at - (uint8_t *)p->getAddress();
+            if (tail > 0) {
+                auto *node = reinterpret_cast<MemListNode*>(at + size);
+                new(node) MemListNode(tail, p->next);
+                p->next = node;
+            }
+            if (wasMax)
+                resetMaxSize();
+            return at;
+        }
+
+        // @brief 内存归还，按地址插回并与前后相邻节点合并（同 ::MemList::deallocate）
+        void deallocate (uint8_t *address, ssize_t size) {
+            MemListNode *p = head;
+            while (p->next && address >= (uint8_t *)p->next->getAddress())
+                p = p->next;
+            MemListNode *next = p->next;
+            if ((uint8_t *)p->getAddress() + p->size == address) {
+                p->size += size;
+                if (next && address + size == next->getAddress()) {
+                    p->size += next->size;
+                    p->next = next->next;
+                }
+                maxSize = std::max(maxSize, p->size);
+            } else if (next && address + size == next->getAddress()) {
+                p->next = reinterpret_cast<MemListNode*>(address);
+                new(p->next) MemListNode(next->size + size, next->next);
+                maxSize = std::max(maxSize, p->next->size);
+            } else {
+                p->next = reinterpret_cast<MemListNode*>(address);
+                new(p->next) MemListNode(size, next);
+                maxSize = std::max(maxSize, size);
+            }
+        }
+
+        // @brief 是否已全部归还（头结点始终位于 beginPos）
+        [[nodiscard]] bool isFree () const {
+            return head->size == beginSize;
+        }
+
+        // @brief O(n) 扫描所有节点更新 maxSize
+        void resetMaxSize () {
+            maxSize = 0;
+            for (MemListNode *p = head; p; p = p->next)
+                maxSize = std::max(maxSize, p->size);
+        }
+
+    public:
+        MemListNode* head;       ///< 头结点
+        ssize_t      maxSize;    ///< 可用最大空间链表节点
+        void*        beginPos;   ///< 管理块的首地址
+        ssize_t      beginSize;  ///< 管理块的大小
+        std::mutex   lock;       ///< 保护本链表的锁
+    };
+
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef _MEMLIST_TLSF_H_
+#define _MEMLIST_TLSF_H_
+
+#include "memlist.h"
+
+#include <cstdint>
+
+// @brief TLSF算法派生MemList
+// 两级分离适应：一级按 2 的幂次、二级再线性细分成 SL_INDEX_COUNT 份管理空闲块
+// 用两级位图 O(1) 找到合适的空闲桶，用边界标记（物理前驱指针）O(1) 合并相邻空闲块
+class MemList_TLSF : public MemList {
+public:
+    MemList_TLSF () = delete;
+    MemList_TLSF (void* pos, ssize_t size);
+    ~MemList_TLSF() override;
+
+    void  print () const override;
+    void  reset () override;
+    [[nodiscard]] bool isFree () const override;
+    void  freeStats (MemListStats &stats) const override;
+    void  deallocate (uint8_t *address, ssize_t size) override;
+    void  deallocateSorted (const std::pair<uint8_t*, ssize_t> *blocks, int count) override;
+    bool  tryExpand (uint8_t *address, ssize_t oldSize, ssize_t newSize) override;
+    void* allocate (ssize_t size) override;
+    void* allocateAligned (ssize_t size, ssize_t alignment) override;
+
+private:
+    static constexpr int     ALIGN_SIZE_LOG2     = 3;
+    static constexpr ssize_t ALIGN_SIZE          = 1 << ALIGN_SIZE_LOG2;
+    static constexpr int     SL_INDEX_COUNT_LOG2 = 5;
+    static constexpr int     SL_INDEX_COUNT      = 1 << SL_INDEX_COUNT_LOG2;
+    static constexpr int     FL_INDEX_SHIFT      = SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2;
+    static constexpr int     FL_INDEX_MAX        = 40;
+    static constexpr int     FL_INDEX_COUNT      = FL_INDEX_MAX - FL_INDEX_SHIFT + 1;
+    static constexpr ssize_t SMALL_BLOCK_SIZE    = 1 << FL_INDEX_SHIFT;
+
+    // @brief 块头（边界标记）
+    // 已分配块只使用 prevPhys 与 size，空闲块还在负载区存放空闲链表指针
+    struct Block {
+        Block*   prevPhys;  ///< 物理上的前一块（首块为 nullptr）
+        ssize_t  size;      ///< 负载大小，最低位标记是否空闲
+        Block*   nextFree;  ///< 同一个桶中的下一个空闲块
+        Block*   prevFree;  ///< 同一个桶中的上一个空闲块
+
+        [[nodiscard]] ssize_t getSize () const { return size & ~(ssize_t)1; }
+        [[nodiscard]] bool    isFree () const  { return size & 1; }
+        [[nodiscard]] uint8_t* payload () { return reinterpret_cast<uint8_t*>(this) + HEADER_SIZE; }
+        [[nodiscard]] Block*  nextPhys () { return reinterpret_cast<Block*>(payload() + getSize()); }
+    };
+
+    static constexpr ssize_t HEADER_SIZE   = sizeof(Block*) + sizeof(ssize_t);
+    static constexpr ssize_t BLOCK_MIN_SIZE = sizeof(Block) - HEADER_SIZE;
+
+    static void    mappingInsert (ssize_t size, int& fl, int& sl);
+    static void    mappingSearch (ssize_t size, int& fl, int& sl);
+    static ssize_t bucketLowerBound (int fl, int sl);
+
+    Block*  searchSuitable (int& fl, int& sl) const;
+    void    insertFree (Block* block);
+    void    removeFree (Block* block);
+    void    trimTail (Block* block, ssize_t size);
+    void    updateMaxSize ();
+
+    Block*    first;                                    ///< 物理上的第一块
+    ssize_t   firstSize;                                ///< 完全空闲时首块的负载大小
+    uint64_t  flBitmap;                                 ///< 一级位图
+    uint32_t  slBitmap[FL_INDEX_COUNT];                 ///< 二级位图
+    Block*    blocks[FL_INDEX_COUNT][SL_INDEX_COUNT];   ///< 各个桶的空闲块链表头
+};
+
+#endif
@@ -13,6 +13,7 @@ public:
     ~MemList_WF() override = default;
 
     void* allocate (ssize_t size) override;
+    void* allocateAligned (ssize_t size, ssize_t alignment) override;
 };
 
 #endif
\ No newline at end of file
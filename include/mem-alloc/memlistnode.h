@@ -3,16 +3,21 @@
 
 #include <cstdio>
 
+namespace zyz {
+    template<class Policy> class MemList;
+}
+
+// 成员函数都很短，定义在头文件中，便于模板内存池内联
 class MemListNode {
 public:
     MemListNode *next;
 
-    MemListNode ();
-    MemListNode (ssize_t _size, MemListNode *_next);
+    MemListNode () : next(nullptr), size(0) {}
+    MemListNode (ssize_t _size, MemListNode *_next) : next(_next), size(_size) {}
     ~MemListNode () = default;
 
-    [[nodiscard]] const void *getAddress () const;
-    [[nodiscard]] ssize_t  getSize () const;
+    [[nodiscard]] const void *getAddress () const { return this; }
+    [[nodiscard]] ssize_t  getSize () const { return size; }
 private:
     ssize_t size;
 
@@ -20,7 +25,8 @@ friend class MemList;
 friend class MemList_FF;
 friend class MemList_WF;
 friend class MemList_BF;
+template<class Policy> friend class zyz::MemList;
 };
 
 
-#endif
\ No newline at end of file
+#endif
@@ -4,19 +4,44 @@
 #include "memlist_ff.h"
 #include "memlist_bf.h"
 #include "memlist_wf.h"
+#include "memlist_tlsf.h"
+#include "threadcache.h"
+#include "capacitytree.h"
+#include "slabcache.h"
+#include "memstats.h"
+#include "memprofiler.h"
 
 #include <string>
 #include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include <unordered_map>
 
 #define FIRST_FIT 1
 #define BEST_FIT  2
 #define WORST_FIT 3
+#define TLSF_FIT  4
+
+// @brief 内存池的可选配置
+struct MemPoolOptions {
+    static constexpr int HUGE_PAGE_NONE        = 0;  ///< hugePage 的取值：不使用大页
+    static constexpr int HUGE_PAGE_TRANSPARENT = 1;  ///< 透明大页
+    static constexpr int HUGE_PAGE_EXPLICIT    = 2;  ///< 显式大页
+    static constexpr ssize_t CACHE_LINE_SIZE   = 64; ///< 缓存行大小，cacheLineThreshold 以上的请求按它对齐
+
+    ssize_t chunkLists   = 0;               ///< 空间不足时每次用 mmap 扩容多少张链表，0 表示不扩容
+    int     hugePage     = HUGE_PAGE_NONE;  ///< 映射时使用的大页：透明大页 / 显式大页（失败退回透明大页）
+    ssize_t retainChunks = 1;               ///< 最多保留几个全空闲的扩容块，超出的归还系统
+    bool    unmapRelease = true;            ///< 归还方式：true 为 munmap，false 为 madvise(MADV_DONTNEED)
+    ssize_t largeThreshold = 0;             ///< 不小于该大小的请求单独 mmap，0 表示取链表大小的一半（至少一页），-1 表示关闭
+    ssize_t cacheLineThreshold = 0;         ///< 不小于该大小的请求至少按 CACHE_LINE_SIZE 对齐（避免伪共享），0 表示关闭
+};
 
 // @brief 内存池
-// 动态分区管理连续内存
+// 动态分区管理内存，开启扩容后由多个不连续的块组成
 class MemPool {
 public:
-    MemPool (ssize_t nLists, ssize_t oneSize, int alloc_algorithm);
+    MemPool (ssize_t nLists, ssize_t oneSize, int alloc_algorithm, const MemPoolOptions& _options = MemPoolOptions());
     ~MemPool ();
 
     MemPool () = delete;
@@ -25,18 +50,86 @@ public:
 
     void    print() const;
 	void  	print(int i) const;
-    void    deallocate (uint8_t *address, ssize_t _size);
-    void*   allocate (ssize_t _size);
+    void    deallocate (uint8_t *address, ssize_t _size, ssize_t alignment = 1);
+    void*   allocate (ssize_t _size, ssize_t alignment = 1);
+    bool    tryExpand (uint8_t *address, ssize_t oldSize, ssize_t newSize, ssize_t alignment = 1);
+    void*   reallocate (uint8_t *address, ssize_t oldSize, ssize_t newSize, ssize_t alignment = 1);
+    int     allocateBatch (int count, ssize_t _size, void **out, ssize_t alignment = 1);
+    void    deallocateBatch (void **blocks, const ssize_t *sizes, int count, ssize_t alignment = 1);
 
     [[nodiscard]] ssize_t getSizeLists() const;
     [[nodiscard]] ssize_t getOneListSize () const;
+    [[nodiscard]] ssize_t getSizeChunks () const;
+    [[nodiscard]] std::vector<ListLockStats> getLockStats () const;
+    [[nodiscard]] MemPoolStats getStats () const;
+
+    void    setProfiler (MemProfiler* _profiler);
+    [[nodiscard]] MemProfiler* getProfiler () const;
 
 private:
+    // @brief 一段连续内存，切分为若干张空闲链表
+    struct MemChunk {
+        uint8_t*  base;      ///< 首地址
+        ssize_t   bytes;     ///< 大小
+        ssize_t   busyLists; ///< 尚未全部归还的链表数
+        bool      mapped;    ///< 由 mmap 得到（否则为 new[]）
+        bool      pinned;    ///< 初始块，永不归还
+        bool      advised;   ///< 已用 madvise 归还物理页
+    };
+
+    uint8_t* mapChunk (ssize_t &bytes) const;
+    MemList* createList (uint8_t *pos) const;
+    void    addChunk (uint8_t *base, ssize_t bytes, bool mapped, bool pinned);
+    bool    grow (ssize_t need);
+    void    releaseChunk (MemChunk *chunk);
+    void    rebuildCapacity ();
+    MemChunk* updateList (int i, bool wasFree);
+    void    recordAllocate (ssize_t _size, void *ret);
+    ssize_t alignmentFor (ssize_t _size, ssize_t alignment) const;
+    int     slabClass (ssize_t _size, ssize_t alignment) const;
+    void*   allocateLarge (ssize_t _size, ssize_t alignment);
+    void    deallocateLarge (uint8_t *address);
+    bool    tryExpandLarge (uint8_t *address, ssize_t newSize);
+    bool    tryExpandInList (uint8_t *address, ssize_t oldSize, ssize_t newSize);
+
+    int     findList (uint8_t *address) const;
+    int     allocateMany (ssize_t _size, ssize_t alignment, int count, void **blocks);
+    void    deallocateMany (void **blocks, int count, ssize_t _size, ssize_t alignment);
+    void    deallocateFromLists (uint8_t *address, ssize_t _size);
+    void*   allocateFromLists (ssize_t _size, ssize_t alignment = 1);
+    int     allocateManyFromLists (ssize_t _size, ssize_t alignment, int count, void **blocks);
+    void    deallocateSortedToLists (std::vector<std::pair<uint8_t*, ssize_t>> &blocks);
+    void    freeBatch (void **blocks, const ssize_t *sizes, int count, ssize_t alignment);
+    void*   searchLists (ssize_t _size, ssize_t alignment, ssize_t need, std::vector<MemChunk*> &release);
+    bool    drainLists (std::vector<MemChunk*> &release);
+    int     nextList (ssize_t need, int start, int prev);
+
     ssize_t       sizeLists;   ///< 空闲链表的数量
     ssize_t       oneListSize; ///< 每个空闲链表的大小
-	uint8_t*      beginPos;	   ///< 内存池真正的起始位置
-    MemList**  	  lists;	   ///< 空闲链表们
-	std::mutex 	  _mutex;	   ///< 操作空闲链表的互斥锁
+	uint8_t*      beginPos;	   ///< 内存池初始块的起始位置
+    std::vector<MemList*>  lists;       ///< 空闲链表们（按首地址升序）
+    std::vector<MemChunk*> chunks;      ///< 组成内存池的各块
+    std::vector<MemChunk*> listChunks;  ///< 每张链表所属的块
+    ssize_t       residentFreeChunks;   ///< 全空闲且仍占用物理内存的扩容块数
+    MemPoolOptions options;    ///< 可选配置
+    ssize_t       largeThreshold; ///< 大对象阈值，-1 表示关闭
+    std::unordered_map<void*, ssize_t> largeObjects; ///< 大对象首地址 -> 映射大小
+    mutable std::mutex _largeMutex; ///< 保护 largeObjects
+    int           algorithm;   ///< 分配算法，同时决定在哪张链表上配置
+    CapacityTree  capacity;    ///< 各链表 maxSize 组成的容量树
+    SlabCache     slabs;       ///< 小对象走的 slab 层
+    bool          useSlabs;    ///< 链表能否容纳整页 slab
+    MemCounters   counters;    ///< 整个内存池的配置/回收计数（线程缓存命中的不经过内存池，不计入）
+    std::atomic<uint64_t> sizeHistogram[MemPoolStats::HISTOGRAM_BUCKETS] = {}; ///< 请求大小直方图
+    std::atomic<MemProfiler*> profiler{nullptr}; ///< 采样分析器，未挂时为 nullptr（配置/回收只多一次判空）
+    mutable std::shared_mutex _structMutex; ///< 保护 lists/chunks 的结构：增删链表时独占，其余操作共享
+	std::mutex 	  _mutex;	   ///< 保护容量树与各块的空闲计数
+    std::mutex    _slabMutex;  ///< 保护 slab 层
+    // 每张链表的内容由其自身的 MemList::lock 保护
+    // 加锁顺序：_slabMutex -> _structMutex -> MemList::lock -> _mutex
+
+friend class ThreadCache;
+friend class SlabCache;
 };
 
 #endif
\ No newline at end of file
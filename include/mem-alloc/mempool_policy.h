@@ -0,0 +1,141 @@
+#ifndef _MEMPOOL_POLICY_H_
+#define _MEMPOOL_POLICY_H_
+
+#include "memlist_policy.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace zyz {
+
+    // @brief 编译期选定分配算法的内存池（仅头文件）
+    // 初始一次性申请 nLists * oneSize 的连续内存并切成等长链表，不扩容
+    // 各链表 maxSize 组成一棵最大值线段树用来选链表，每张链表各有一把锁
+    // 运行期选算法、带线程缓存/slab/扩容的 ::MemPool 保持不变
+    // @tparam Policy FirstFit / BestFit / WorstFit
+    template<class Policy>
+    class MemPool {
+    public:
+        MemPool () = delete;
+        MemPool (const MemPool& that) = delete;
+        MemPool& operator = (const MemPool& that) = delete;
+
+        // @brief 内存池初始化
+        // @parma nLists  空闲链表数量
+        // @parma oneSize 每个空闲链表可用空间大小
+        MemPool (ssize_t nLists, ssize_t oneSize) : sizeLists(nLists), oneListSize(oneSize), leaves(1) {
+            beginPos = new uint8_t[nLists * oneSize];
+            for (ssize_t i = 0; i < nLists; i ++)
+                lists.emplace_back(new MemList<Policy>(beginPos + i * oneSize, oneSize));
+            while (leaves < nLists)
+                leaves <<= 1;
+            tree.assign(leaves << 1, -1);
+            for (int i = 0; i < nLists; i ++)
+                update(i, oneSize);
+        }
+
+        ~MemPool () {
+            lists.clear();
+            delete[] beginPos;
+        }
+
+        // @brief 内存配置
+        //     在线段树上选出容量够用的链表（剩余空间还要能保存一个空闲节点），锁住它调用 allocate
+        //     选出后到加锁前链表可能被别的线程用掉，失败就继续找下一张
+        // @parma alignment 对齐要求（2 的幂次），大于 1 时在空闲节点中切出对齐的一段
+        // @return
+        //     - not nullptr: successfully
+        //     - nullptr:     failure
+        void* allocate (ssize_t _size, ssize_t alignment = 1) {
+            if (alignment <= 0 || (alignment & (alignment - 1)))
+                return nullptr;
+            // 对齐时前后各可能剩下一个空闲节点，最多浪费 2 * alignment
+            ssize_t need = alignment > 1 ? _size + 2 * alignment + 2 * (ssize_t)sizeof(MemListNode)
+                                         : _size + (ssize_t)sizeof(MemListNode);
+            int i;
+            {
+                std::lock_guard<std::mutex> guard(treeMutex);
+                i = Policy::WIDEST_LIST ? widest(need) : firstFit(need, 0);
+            }
+            while (i != -1) {
+                MemList<Policy>& list = *lists[i];
+                void* ret;
+                {
+                    std::lock_guard<std::mutex> guard(list.lock);
+                    ret = alignment > 1 ? list.allocateAligned(_size, alignment) : list.allocate(_size);
+                    update(i, list.maxSize);
+                }
+                if (ret)
+                    return ret;
+                std::lock_guard<std::mutex> guard(treeMutex);
+                i = firstFit(need, i + 1);
+            }
+            return nullptr;
+        }
+
+        // @brief 内存回归，链表等长连续，O(1) 算出所属链表
+        void deallocate (uint8_t *address, ssize_t _size) {
+            int i = (int)((address - beginPos) / oneListSize);
+            MemList<Policy>& list = *lists[i];
+            std::lock_guard<std::mutex> guard(list.lock);
+            list.deallocate(address, _size);
+            update(i, list.maxSize);
+        }
+
+        [[nodiscard]] ssize_t getSizeLists () const { return sizeLists; }
+        [[nodiscard]] ssize_t getOneListSize () const { return oneListSize; }
+
+    private:
+        // @brief 第 i 张链表的容量改为 cap（调用方持有该链表的锁）
+        void update (int i, ssize_t cap) {
+            std::lock_guard<std::mutex> guard(treeMutex);
+            ssize_t pos = i + leaves;
+            tree[pos] = cap;
+            for (pos >>= 1; pos; pos >>= 1) {
+                ssize_t mx = std::max(tree[pos << 1], tree[pos << 1 | 1]);
+                if (tree[pos] == mx)
+                    break;
+                tree[pos] = mx;
+            }
+        }
+
+        // @brief 下标不小于 from 的第一张容量 >= need 的链表（持有 treeMutex）
+        int firstFit (ssize_t need, int from) const {
+            if (from >= sizeLists || tree[1] < need)
+                return -1;
+            return firstFit(1, 0, (int)leaves - 1, need, from);
+        }
+
+        int firstFit (ssize_t node, int l, int r, ssize_t need, int from) const {
+            if (r < from || tree[node] < need)
+                return -1;
+            if (l == r)
+                return l;
+            int mid = (l + r) >> 1;
+            int ret = firstFit(node << 1, l, mid, need, from);
+            return ret != -1 ? ret : firstFit(node << 1 | 1, mid + 1, r, need, from);
+        }
+
+        // @brief 容量最大的链表，不足 need 时为 -1（持有 treeMutex）
+        int widest (ssize_t need) const {
+            if (tree[1] < need)
+                return -1;
+            ssize_t pos = 1;
+            while (pos < leaves)
+                pos = tree[pos << 1] == tree[pos] ? pos << 1 : pos << 1 | 1;
+            return (int)(pos - leaves);
+        }
+
+        ssize_t       sizeLists;    ///< 空闲链表的数量
+        ssize_t       oneListSize;  ///< 每个空闲链表的大小
+        uint8_t*      beginPos;     ///< 内存池的起始位置
+        std::vector<std::unique_ptr<MemList<Policy>>> lists;  ///< 空闲链表们（按首地址升序）
+        ssize_t       leaves;       ///< 线段树叶子数
+        std::vector<ssize_t> tree;  ///< 各链表 maxSize 组成的最大值线段树
+        std::mutex    treeMutex;    ///< 保护 tree
+    };
+
+}
+
+#endif
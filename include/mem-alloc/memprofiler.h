@@ -0,0 +1,79 @@
+#ifndef _MEM_PROFILER_H_
+#define _MEM_PROFILER_H_
+
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+// @brief 采样式配置分析器
+// 与 tcmalloc 的采样器相同：每个线程记一个字节倒计数，配置时减去请求大小，减到 0 就采样这次配置并重新抽取间隔
+// 间隔服从均值为 sampleInterval 的指数分布，每配置 sampleInterval 字节平均采样一次，大块更容易被采到
+// 采样记录调用栈（backtrace）与大小，存入按地址分片的存活表，回收时移除
+// 通过 MemPool::setProfiler 挂到内存池上；未挂时内存池只多一次指针判空
+class MemProfiler {
+public:
+    static constexpr int     MAX_DEPTH        = 32;         ///< 调用栈最大深度
+    static constexpr ssize_t DEFAULT_INTERVAL = 512 << 10;  ///< 默认平均采样间隔（字节）
+    static constexpr int     SHARDS           = 16;         ///< 存活表分片数
+
+    // @brief 一次被采样的配置
+    struct Sample {
+        ssize_t size;               ///< 请求大小
+        int     depth;              ///< 调用栈深度
+        void*   frames[MAX_DEPTH];  ///< 调用栈（frames[0] 为最内层）
+    };
+
+    explicit MemProfiler (ssize_t _sampleInterval = DEFAULT_INTERVAL);
+
+    MemProfiler (const MemProfiler& that) = delete;
+    MemProfiler& operator = (const MemProfiler& that) = delete;
+
+    // @brief 一次配置：倒计数没减到 0 时只有一次减法与一次比较
+    void onAllocate (void* address, ssize_t size) {
+        if ((bytesUntilSample -= size) > 0)
+            return;
+        sample(address, size);
+    }
+
+    // @brief 一次回收：没有存活的采样时直接返回
+    void onFree (void* address) {
+        if (liveSamples.load(std::memory_order_relaxed) == 0)
+            return;
+        forget(address);
+    }
+
+    void    onResize (void* address, ssize_t newSize);
+
+    [[nodiscard]] std::vector<Sample> snapshot () const;
+    void    dumpFolded (std::ostream& out) const;
+    void    dumpPprof (std::ostream& out) const;
+
+    [[nodiscard]] ssize_t getSampleInterval () const noexcept;
+    [[nodiscard]] ssize_t getLiveSamples () const noexcept;
+    [[nodiscard]] double  estimateLiveBytes () const;
+
+private:
+    // @brief 存活表的一片
+    struct Shard {
+        mutable std::mutex lock;
+        std::unordered_map<void*, Sample> live;  ///< 首地址 -> 采样
+    };
+
+    void    sample (void* address, ssize_t size);
+    void    forget (void* address);
+    [[nodiscard]] ssize_t nextInterval () const;
+    [[nodiscard]] double  weight (ssize_t size) const;
+    [[nodiscard]] Shard&  shardOf (void* address) const;
+
+    ssize_t sampleInterval;             ///< 平均采样间隔
+    std::atomic<ssize_t> liveSamples;   ///< 存活的采样数
+    mutable Shard shards[SHARDS];       ///< 存活表
+
+    static inline thread_local ssize_t bytesUntilSample = 0;  ///< 本线程距下一次采样还剩的字节数
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef _MEM_RESOURCE_H_
+#define _MEM_RESOURCE_H_
+
+#include <cstddef>
+#include <memory_resource>
+
+class MemPool;
+
+// @brief 以 MemPool 为上游的 std::pmr::memory_resource
+// 让 std::pmr::vector / std::pmr::unordered_map / std::pmr::string 等标准容器从内存池取内存
+// 每次 配置/回收 直接调用内存池（只锁所属链表），可在多线程间共享
+// 对齐：直接交给内存池的对齐配置（支持超对齐请求），不额外占用空间
+class MemPoolResource : public std::pmr::memory_resource {
+public:
+    MemPoolResource () = delete;
+    explicit MemPoolResource (MemPool* _pool);
+
+    MemPoolResource (const MemPoolResource& that) = delete;
+    MemPoolResource& operator = (const MemPoolResource& that) = delete;
+
+    [[nodiscard]] MemPool* getPool () const noexcept;
+
+protected:
+    void* do_allocate (std::size_t bytes, std::size_t alignment) override;
+    void  do_deallocate (void* p, std::size_t bytes, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal (const std::pmr::memory_resource& other) const noexcept override;
+
+    virtual void* rawAllocate (std::size_t bytes, std::size_t alignment);
+    virtual void  rawDeallocate (void* p, std::size_t bytes, std::size_t alignment);
+
+    MemPool* pool;  ///< 上游内存池
+};
+
+// @brief 经过线程本地缓存的 MemPoolResource
+// 小块在当前线程的 ThreadCache 中 配置/回收，缓存 空/满 时才批量访问内存池
+class CachedMemPoolResource : public MemPoolResource {
+public:
+    explicit CachedMemPoolResource (MemPool* _pool);
+
+protected:
+    void* rawAllocate (std::size_t bytes, std::size_t alignment) override;
+    void  rawDeallocate (void* p, std::size_t bytes, std::size_t alignment) override;
+};
+
+#endif
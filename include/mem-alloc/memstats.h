@@ -0,0 +1,63 @@
+#ifndef _MEM_STATS_H_
+#define _MEM_STATS_H_
+
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// @brief 配置/回收计数器
+// 全部为 relaxed 原子量，只保证各自计数准确，可在生产环境常开
+class MemCounters {
+public:
+    void onAllocate (ssize_t size);
+    void onFree (ssize_t size);
+    void onFail ();
+    void onResize (ssize_t oldSize, ssize_t newSize);
+
+    std::atomic<uint64_t> allocations{0};       ///< 成功配置次数
+    std::atomic<uint64_t> frees{0};             ///< 回收次数
+    std::atomic<uint64_t> failedAllocations{0}; ///< 配置失败次数
+    std::atomic<int64_t>  bytesInUse{0};        ///< 已配置未回收的字节数（按请求大小）
+    std::atomic<int64_t>  peakBytesInUse{0};    ///< bytesInUse 的峰值
+
+private:
+    void updatePeak (int64_t now);
+};
+
+// @brief 单张空闲链表的统计快照
+struct MemListStats {
+    uint64_t allocations       = 0;
+    uint64_t frees             = 0;
+    uint64_t failedAllocations = 0;  ///< 作为候选链表却没能配置出来的次数
+    int64_t  bytesInUse        = 0;
+    int64_t  peakBytesInUse    = 0;
+    ssize_t  freeBlocks        = 0;  ///< 空闲块数
+    ssize_t  freeBytes         = 0;  ///< 空闲字节数
+    ssize_t  largestFreeBlock  = 0;  ///< 最大空闲块
+    double   fragmentation     = 0;  ///< 外部碎片率：1 - largestFreeBlock / freeBytes
+};
+
+// @brief 内存池的统计快照
+struct MemPoolStats {
+    static constexpr int HISTOGRAM_BUCKETS = 48;
+
+    uint64_t allocations       = 0;
+    uint64_t frees             = 0;
+    uint64_t failedAllocations = 0;
+    int64_t  bytesInUse        = 0;
+    int64_t  peakBytesInUse    = 0;
+    ssize_t  freeBlocks        = 0;
+    ssize_t  freeBytes         = 0;
+    ssize_t  largestFreeBlock  = 0;  ///< 所有链表中最大的空闲块
+    double   fragmentation     = 0;  ///< 外部碎片率：1 - largestFreeBlock / freeBytes
+    ssize_t  largeObjects      = 0;  ///< 存活的大对象数
+    uint64_t sizeHistogram[HISTOGRAM_BUCKETS] = {};  ///< 请求大小直方图，第 i 桶为 [2^i, 2^(i+1))
+    std::vector<MemListStats> lists;                 ///< 各链表（按首地址顺序）
+
+    [[nodiscard]] static int histogramBucket (ssize_t size);
+    [[nodiscard]] std::string toJson () const;
+};
+
+#endif
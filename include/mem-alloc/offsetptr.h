@@ -0,0 +1,153 @@
+#ifndef _OFFSET_PTR_H_
+#define _OFFSET_PTR_H_
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace zyz {
+
+	// @brief 自相对指针：保存目标地址与自身地址之差，而不是绝对地址
+	// 一整段内存（如映射的文件）换到别的基址后，段内互相指向的 OffsetPtr 仍然有效
+	// 复制/赋值时按自身的新位置重新计算差值，因此不能用 memcpy 搬动
+	// 差值为 1 表示空指针（自身地址加 1 落在指针自己身上，不会是别的对象）
+	template<class T>
+	class OffsetPtr {
+	public:
+		using element_type = T;
+		using value_type = std::remove_cv_t<T>;
+		using difference_type = ptrdiff_t;
+		using pointer = T *;
+		using iterator_category = std::random_access_iterator_tag;
+
+		template<class U>
+		using rebind = OffsetPtr<U>;
+
+		OffsetPtr() noexcept : off(NULL_OFFSET) {}
+
+		OffsetPtr(std::nullptr_t) noexcept : off(NULL_OFFSET) {}
+
+		OffsetPtr(T *p) noexcept {
+			set(p);
+		}
+
+		OffsetPtr(const OffsetPtr &that) noexcept {
+			set(that.get());
+		}
+
+		template<class U> requires std::is_convertible_v<U *, T *>
+		OffsetPtr(const OffsetPtr<U> &that) noexcept {
+			set(that.get());
+		}
+
+		OffsetPtr &operator=(const OffsetPtr &that) noexcept {
+			set(that.get());
+			return *this;
+		}
+
+		OffsetPtr &operator=(T *p) noexcept {
+			set(p);
+			return *this;
+		}
+
+		// @brief 当前映射下的绝对地址
+		[[nodiscard]] T *get() const noexcept {
+			if (off == NULL_OFFSET)
+				return nullptr;
+			return reinterpret_cast<T *>(reinterpret_cast<uintptr_t>(this) + off);
+		}
+
+		T *operator->() const noexcept {
+			return get();
+		}
+
+		template<class U = T> requires (!std::is_void_v<U>)
+		U &operator*() const noexcept {
+			return *get();
+		}
+
+		template<class U = T> requires (!std::is_void_v<U>)
+		U &operator[](difference_type i) const noexcept {
+			return get()[i];
+		}
+
+		explicit operator bool() const noexcept {
+			return off != NULL_OFFSET;
+		}
+
+		// @brief std::pointer_traits 由引用得到指针
+		template<class U = T> requires (!std::is_void_v<U>)
+		static OffsetPtr pointer_to(U &r) noexcept {
+			return OffsetPtr(&r);
+		}
+
+		OffsetPtr &operator+=(difference_type n) noexcept {
+			set(get() + n);
+			return *this;
+		}
+
+		OffsetPtr &operator-=(difference_type n) noexcept {
+			set(get() - n);
+			return *this;
+		}
+
+		OffsetPtr &operator++() noexcept {
+			return *this += 1;
+		}
+
+		OffsetPtr &operator--() noexcept {
+			return *this -= 1;
+		}
+
+		OffsetPtr operator++(int) noexcept {
+			OffsetPtr ret(*this);
+			++*this;
+			return ret;
+		}
+
+		OffsetPtr operator--(int) noexcept {
+			OffsetPtr ret(*this);
+			--*this;
+			return ret;
+		}
+
+		friend OffsetPtr operator+(const OffsetPtr &p, difference_type n) noexcept {
+			return OffsetPtr(p.get() + n);
+		}
+
+		friend OffsetPtr operator-(const OffsetPtr &p, difference_type n) noexcept {
+			return OffsetPtr(p.get() - n);
+		}
+
+		friend difference_type operator-(const OffsetPtr &a, const OffsetPtr &b) noexcept {
+			return a.get() - b.get();
+		}
+
+		friend bool operator==(const OffsetPtr &a, const OffsetPtr &b) noexcept {
+			return a.get() == b.get();
+		}
+
+		friend bool operator==(const OffsetPtr &a, std::nullptr_t) noexcept {
+			return !a;
+		}
+
+		friend std::strong_ordering operator<=>(const OffsetPtr &a, const OffsetPtr &b) noexcept {
+			return std::compare_three_way()(a.get(), b.get());
+		}
+
+	private:
+		static constexpr ptrdiff_t NULL_OFFSET = 1;
+
+		void set(T *p) noexcept {
+			off = p == nullptr ? NULL_OFFSET
+							   : (ptrdiff_t)(reinterpret_cast<uintptr_t>(p) - reinterpret_cast<uintptr_t>(this));
+		}
+
+		ptrdiff_t off;	///< 目标地址 - 自身地址
+	};
+
+}
+
+#endif
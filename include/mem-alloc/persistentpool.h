@@ -0,0 +1,142 @@
+#ifndef _PERSISTENT_POOL_H_
+#define _PERSISTENT_POOL_H_
+
+#include "offsetptr.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// @brief 持久化内存池
+// 整个池放在 mmap(MAP_SHARED) 映射的文件里：文件头、空闲链表与所有已配置的块都在文件中
+// 空闲链表按地址升序，节点间用相对文件首地址的偏移链接，不保存任何绝对地址，重新打开时可以映射到任意基址
+// 配置为首次适应（从空闲块前部切出），回收时与前后相邻的空闲块合并
+// 文件头中有一张按名字登记的根表，重启后用 getRoot 找回之前构建好的数据结构
+// 块之间互相指向要用 zyz::OffsetPtr（配合 zyz::PersistentAllocator），重新打开只需映射文件，数据随缺页载入
+// 进程内由一把锁保护；打开期间对文件加 flock，同一个文件同一时刻只能由一个池打开
+// 文件头记录是否正常关闭，崩溃后重新打开时先检查空闲链表，损坏则拒绝打开
+class PersistentPool {
+public:
+    static constexpr ssize_t GRANULARITY = 16;  ///< 配置粒度，所有块的大小与地址都是它的倍数
+    static constexpr int     MAX_ROOTS   = 32;  ///< 根表容量
+    static constexpr int     ROOT_NAME   = 48;  ///< 根名字的最大长度（含结尾的 0）
+
+    PersistentPool () = delete;
+    PersistentPool (const std::string& _path, ssize_t _bytes);
+    ~PersistentPool ();
+
+    PersistentPool (const PersistentPool& that) = delete;
+    PersistentPool& operator = (const PersistentPool& that) = delete;
+
+    void*   allocate (ssize_t _size, ssize_t alignment = 1);
+    void    deallocate (uint8_t *address, ssize_t _size, ssize_t alignment = 1);
+
+    bool    setRoot (const std::string& name, const void* address);
+    [[nodiscard]] void* getRoot (const std::string& name) const;
+    void    flush ();
+
+    [[nodiscard]] bool     isReopened () const noexcept;
+    [[nodiscard]] uint8_t* getBase () const noexcept;
+    [[nodiscard]] ssize_t  getBytes () const noexcept;
+    [[nodiscard]] ssize_t  getUsedBytes () const;
+
+private:
+    struct Header;
+    struct FreeNode;
+
+    static uint64_t dataOffset ();
+    [[nodiscard]] Header*   header () const;
+    [[nodiscard]] FreeNode* node (uint64_t offset) const;
+    uint64_t& link (uint64_t prev) const;
+    void    insertFree (uint64_t offset, uint64_t size);
+    [[nodiscard]] bool checkFreeList () const;
+    int     findRoot (const std::string& name) const;
+
+    std::string  path;       ///< 文件路径
+    int          fd;         ///< 文件描述符
+    uint8_t*     base;       ///< 本次映射的首地址
+    ssize_t      bytes;      ///< 文件（映射）大小
+    bool         reopened;   ///< 是否打开的是已有的池
+    mutable std::mutex _mutex;  ///< 保护空闲链表与根表
+};
+
+namespace zyz {
+
+	// @brief 从 PersistentPool 配置的配置器
+	// pointer 为 OffsetPtr<T>，容器内部的指针都是自相对的，整个池换到别的基址后仍然有效
+	// 指向同一个池的配置器相等，容器 复制/移动/交换 时随之传播
+	template<class T>
+	class PersistentAllocator {
+	public:
+		using value_type = T;
+		using pointer = OffsetPtr<T>;
+		using const_pointer = OffsetPtr<const T>;
+		using void_pointer = OffsetPtr<void>;
+		using const_void_pointer = OffsetPtr<const void>;
+		using reference = T &;
+		using const_reference = const T &;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+		using is_always_equal = std::false_type;
+
+		template<class U>
+		struct rebind {
+			using other = PersistentAllocator<U>;
+		};
+
+		explicit PersistentAllocator(PersistentPool *_pool) noexcept : pool(_pool) {}
+
+		template<class U>
+		PersistentAllocator(const PersistentAllocator<U> &that) noexcept : pool(that.getPool()) {}
+
+		pointer allocate(size_type n, const void * = nullptr) const {
+			return pointer(reinterpret_cast<T *>(pool->allocate((ssize_t)(n * sizeof(T)), (ssize_t)alignof(T))));
+		}
+
+		void deallocate(pointer p, size_type n) const {
+			pool->deallocate(reinterpret_cast<uint8_t *>(p.get()), (ssize_t)(n * sizeof(T)), (ssize_t)alignof(T));
+		}
+
+		template<class ...Args>
+		static void construct(T *p, Args&& ...args) {
+			new(p) T(std::forward<Args>(args)...);
+		}
+
+		static void destroy(T *p) {
+			p->~T();
+		}
+
+		PersistentAllocator select_on_container_copy_construction() const {
+			return *this;
+		}
+
+		[[nodiscard]] PersistentPool *getPool() const noexcept {
+			return pool;
+		}
+
+	private:
+		PersistentPool *pool;	///< 绑定的池（本进程中的对象，不写入文件）
+	};
+
+	template<class T, class U>
+	bool operator==(const PersistentAllocator<T> &a, const PersistentAllocator<U> &b) noexcept {
+		return a.getPool() == b.getPool();
+	}
+
+	template<class T, class U>
+	bool operator!=(const PersistentAllocator<T> &a, const PersistentAllocator<U> &b) noexcept {
+		return a.getPool() != b.getPool();
+	}
+
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef _SLAB_CACHE_H_
+#define _SLAB_CACHE_H_
+
+#include <cstdio>
+#include <cstdint>
+#include <unordered_map>
+
+class MemPool;
+
+// @brief 小对象 slab 分配器
+// 把不超过 MAX_CLASS_SIZE 的请求按大小分级，每级从内存池整页（SLAB_SIZE）申请 slab
+// slab 切成等长对象，空闲对象以侵入式单链表串起来，配置与回收都是 O(1)
+// 对象全部归还的 slab 每级只留一个备用，其余还给内存池
+class SlabCache {
+public:
+    static constexpr ssize_t SLAB_SIZE      = 4096; ///< 一个 slab 的大小
+    static constexpr ssize_t SLAB_ALIGN     = 64;   ///< slab 页的对齐，对象大小是 alignment 倍数时对象也按 alignment 对齐
+    static constexpr ssize_t MAX_CLASS_SIZE = 512;  ///< 走 slab 的最大请求
+    static constexpr int     NUM_CLASSES    = 16;   ///< 16~128 步长 16，~256 步长 32，~512 步长 64
+
+    SlabCache () = delete;
+    explicit SlabCache (MemPool* _pool);
+    ~SlabCache () = default;
+
+    SlabCache (const SlabCache& that) = delete;
+    SlabCache& operator = (const SlabCache& that) = delete;
+
+    static int     classOf (ssize_t size);
+    static int     classOf (ssize_t size, ssize_t alignment);
+    static ssize_t classSize (int cls);
+
+    void*   allocate (int cls);
+    void    deallocate (int cls, void* address);
+    void    release ();
+
+private:
+    // @brief 空闲对象的侵入式链表节点
+    struct FreeObject {
+        FreeObject* next;
+    };
+
+    // @brief 一个 slab 的元数据（放在页外，页内全部用来存对象）
+    struct Slab {
+        uint8_t*     base;      ///< 页首地址
+        int          used;      ///< 已配置出去的对象数
+        FreeObject*  freeList;  ///< 回收回来的对象
+        uint8_t*     bumpPos;   ///< 尚未切出的位置
+        Slab*        prev;      ///< 未满 slab 双向链表
+        Slab*        next;
+    };
+
+    // @brief 一级 slab 的状态
+    struct SizeClass {
+        Slab*   partial;        ///< 还有空位的 slab
+        Slab*   empty;          ///< 备用的空 slab
+        int     capacity;       ///< 每个 slab 能放的对象数
+    };
+
+    Slab*   findSlab (void* address) const;
+    void    linkPartial (SizeClass& c, Slab* slab);
+    void    unlinkPartial (SizeClass& c, Slab* slab);
+    void    freeSlab (Slab* slab);
+
+    MemPool*   pool;                    ///< slab 页的来源
+    SizeClass  classes[NUM_CLASSES];
+    // slab 不一定按页对齐，一页最多被两个 slab 覆盖：
+    // key = 页号 * 2 + 1 记录从该页开始的 slab，key = 页号 * 2 记录在该页结束的 slab
+    std::unordered_map<uintptr_t, Slab*> pageIndex;
+};
+
+#endif
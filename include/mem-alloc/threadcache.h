@@ -0,0 +1,56 @@
+#ifndef _THREAD_CACHE_H_
+#define _THREAD_CACHE_H_
+
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+
+class MemPool;
+
+// @brief 线程本地缓存
+// 每个线程对每个内存池持有一份，按大小分级缓存最近释放的块（magazine）
+// 配置与回收先走本地缓存，缓存 空/满 时才加锁向内存池批量 补充/归还
+class ThreadCache {
+public:
+    static constexpr ssize_t CLASS_GRANULARITY = 16;    ///< 大小分级的粒度（不小于 sizeof(MemListNode)），缓存块都按它对齐
+    static constexpr ssize_t MAX_CACHED_SIZE   = 256;   ///< 可缓存的最大块，更大的直接找内存池
+    static constexpr ssize_t NUM_CLASSES       = MAX_CACHED_SIZE / CLASS_GRANULARITY;
+    static constexpr int     MAGAZINE_SIZE     = 64;    ///< 每一级缓存的容量
+    static constexpr int     BATCH_SIZE        = 32;    ///< 一次 补充/归还 的块数
+
+    ThreadCache () = delete;
+    explicit ThreadCache (MemPool* _pool, bool _direct = false);
+    ~ThreadCache ();
+
+    ThreadCache (const ThreadCache& that) = delete;
+    ThreadCache& operator = (const ThreadCache& that) = delete;
+
+    static ThreadCache* local (MemPool* _pool);
+    static void         detach (MemPool* _pool);
+    static ssize_t      classSize (ssize_t size);
+
+    void*   allocate (ssize_t size, ssize_t alignment = 1);
+    void    deallocate (void* address, ssize_t size, ssize_t alignment = 1);
+    bool    tryExpand (void* address, ssize_t oldSize, ssize_t newSize, ssize_t alignment = 1);
+    int     allocateBatch (int count, ssize_t size, void** out, ssize_t alignment = 1);
+    void    deallocateBatch (void** blocks, int count, ssize_t size, ssize_t alignment = 1);
+    void    flush ();
+
+private:
+    static ThreadCache* directCache (MemPool* _pool);
+
+    void    refill (int cls);
+    void    release (int cls, int count);
+
+    // @brief 单级缓存，栈式存放同一大小的空闲块
+    struct Magazine {
+        int   count;
+        void* blocks[MAGAZINE_SIZE];
+    };
+
+    std::atomic<MemPool*> pool;         ///< 所属内存池（池析构后由 detach 在别的线程置空，所以是原子的）
+    bool      direct;                   ///< 直通缓存：不存块，配置/回收都直接找内存池
+    Magazine  magazines[NUM_CLASSES];   ///< 各级缓存
+};
+
+#endif
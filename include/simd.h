@@ -0,0 +1,46 @@
+#ifndef MEM_MANAGE_SIMD_H
+#define MEM_MANAGE_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+// @brief int32_t / float 连续区间上的 查找/计数/最值/求和 向量化内核
+// 首次调用时按 CPU 支持选 AVX2、SSE4.2 或标量实现，之后每次调用只多一次间接跳转
+// 一般通过 algorithm.h 中的 zyz::find / zyz::count / zyz::min_element / zyz::max_element / zyz::reduce / zyz::sum / zyz::contains 使用
+namespace zyz::simd {
+
+	// @brief 内核级别，数值越大越快；detectLevel / getLevel / setLevel 使用
+	inline constexpr int LEVEL_SCALAR = 0;
+	inline constexpr int LEVEL_SSE42  = 1;
+	inline constexpr int LEVEL_AVX2   = 2;
+
+	// @brief CPU 支持的最高级别
+	int  detectLevel ();
+
+	// @brief 当前使用的级别
+	int  getLevel ();
+
+	// @brief 指定使用的级别（不超过 CPU 支持的最高级别），返回实际生效的级别
+	int  setLevel (int level);
+
+	// @brief 第一个等于 value 的位置，没有为 last
+	const int32_t* find (const int32_t* first, const int32_t* last, int32_t value);
+	const float*   find (const float* first, const float* last, float value);
+
+	// @brief 等于 value 的元素个数
+	ptrdiff_t count (const int32_t* first, const int32_t* last, int32_t value);
+	ptrdiff_t count (const float* first, const float* last, float value);
+
+	// @brief 最小值 / 最大值，区间不能为空；float 跳过 NaN，全是 NaN 时返回 NaN
+	int32_t minValue (const int32_t* first, const int32_t* last);
+	float   minValue (const float* first, const float* last);
+	int32_t maxValue (const int32_t* first, const int32_t* last);
+	float   maxValue (const float* first, const float* last);
+
+	// @brief 求和：int32_t 用 64 位累加不会溢出；float 分多路累加，结果与顺序累加的舍入可能不同
+	int64_t sum (const int32_t* first, const int32_t* last);
+	float   sum (const float* first, const float* last);
+
+}
+
+#endif //MEM_MANAGE_SIMD_H
@@ -0,0 +1,84 @@
+#include "capacitytree.h"
+
+#include <algorithm>
+
+// @brief 构造
+// @parma n             链表数量
+// @parma _trackBestFit 是否支持 bestFit 查询
+//    所有叶子初始化为 -1（不可用），需要调用方逐个 update
+CapacityTree::CapacityTree(ssize_t n, bool _trackBestFit) :
+        size(0),
+        leaves(0),
+        tree(nullptr),
+        trackBestFit(_trackBestFit) {
+    resize(n);
+}
+
+CapacityTree::~CapacityTree() {
+    delete[] tree;
+}
+
+// @brief 链表数量变化后重建，所有叶子重新置为 -1
+void CapacityTree::resize(ssize_t n) {
+    delete[] tree;
+    size = n;
+    leaves = 1;
+    while (leaves < n)
+        leaves <<= 1;
+    tree = new ssize_t[leaves * 2];
+    for (ssize_t i = 0; i < leaves * 2; i ++)
+        tree[i] = -1;
+    ordered.clear();
+}
+
+// @brief 单点更新第 i 张链表的容量，并向上维护最大值
+void CapacityTree::update(int i, ssize_t capacity) {
+    ssize_t pos = leaves + i;
+    if (trackBestFit) {
+        ordered.erase({tree[pos], i});
+        ordered.insert({capacity, i});
+    }
+    tree[pos] = capacity;
+    for (pos >>= 1; pos; pos >>= 1) {
+        ssize_t mx = std::max(tree[pos << 1], tree[pos << 1 | 1]);
+        if (tree[pos] == mx)
+            break;
+        tree[pos] = mx;
+    }
+}
+
+// @brief 下标不小于 from 的第一张容量 >= need 的链表
+// @return 链表下标，不存在为 -1
+int CapacityTree::firstFit(ssize_t need, int from) const {
+    if (from >= size || tree[1] < need)
+        return -1;
+    return firstFit(1, 0, (int)leaves - 1, need, from);
+}
+
+int CapacityTree::firstFit(int node, int l, int r, ssize_t need, int from) const {
+    if (r < from || tree[node] < need)
+        return -1;
+    if (l == r)
+        return l;
+    int mid = (l + r) >> 1;
+    int ret = firstFit(node << 1, l, mid, need, from);
+    if (ret == -1)
+        ret = firstFit(node << 1 | 1, mid + 1, r, need, from);
+    return ret;
+}
+
+// @brief 容量最大的链表（容量不足 need 时为 -1）
+int CapacityTree::worstFit(ssize_t need) const {
+    if (tree[1] < need)
+        return -1;
+    ssize_t pos = 1;
+    while (pos < leaves)
+        pos = tree[pos << 1] == tree[pos] ? pos << 1 : pos << 1 | 1;
+    return (int)(pos - leaves);
+}
+
+// @brief 容量 >= need 中最小的链表（需在构造时开启 trackBestFit）
+int CapacityTree::bestFit(ssize_t need) const {
+    auto it = ordered.lower_bound({need, -1});
+    return it == ordered.end() ? -1 : it->second;
+}
@@ -0,0 +1,37 @@
+#include "listlock.h"
+
+// @brief 阻塞加锁，需要等待时记一次竞争
+void ListLock::lock() {
+	if (!mutex.try_lock()) {
+		contentions.fetch_add(1, std::memory_order_relaxed);
+		mutex.lock();
+	}
+	acquisitions.fetch_add(1, std::memory_order_relaxed);
+	lockedAt = std::chrono::steady_clock::now();
+}
+
+// @brief 尝试加锁，失败记一次竞争
+bool ListLock::try_lock() {
+	if (!mutex.try_lock()) {
+		contentions.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	acquisitions.fetch_add(1, std::memory_order_relaxed);
+	lockedAt = std::chrono::steady_clock::now();
+	return true;
+}
+
+// @brief 解锁并累计持有时间
+void ListLock::unlock() {
+	auto cost = std::chrono::steady_clock::now() - lockedAt;
+	holdNanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(cost).count(), std::memory_order_relaxed);
+	mutex.unlock();
+}
+
+ListLockStats ListLock::stats() const {
+	ListLockStats ret;
+	ret.acquisitions = acquisitions.load(std::memory_order_relaxed);
+	ret.contentions = contentions.load(std::memory_order_relaxed);
+	ret.holdNanos = holdNanos.load(std::memory_order_relaxed);
+	return ret;
+}
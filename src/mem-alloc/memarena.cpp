@@ -0,0 +1,102 @@
+#include "memarena.h"
+#include "mempool.h"
+
+#include <algorithm>
+
+// @parma _pool      块的来源
+// @parma _blockSize 每次向内存池申请的块大小（超过它的请求单独申请一块）
+MemArena::MemArena(MemPool* _pool, ssize_t _blockSize) :
+		pool(_pool),
+		blockSize(std::max(_blockSize, (ssize_t)sizeof(Block) + DEFAULT_ALIGNMENT)),
+		reservedBytes(0),
+		first(nullptr),
+		current(nullptr),
+		pos(nullptr),
+		end(nullptr) {}
+
+// @brief 析构，所有块还给内存池
+MemArena::~MemArena() {
+	release();
+}
+
+// @brief 当前块放不下时的配置
+//     紧随其后的块（之前 rewind/reset 留下的）放得下就接着用
+//     否则向内存池申请一块（至少 blockSize）插在当前块之后，原来的后继块继续留着
+void* MemArena::allocateSlow(ssize_t size, ssize_t alignment) {
+	ssize_t need = (ssize_t)sizeof(Block) + size + alignment;
+	Block* next = current ? current->next : first;
+	if (next == nullptr || next->bytes < need) {
+		ssize_t bytes = std::max(blockSize, need);
+		auto* block = reinterpret_cast<Block*>(pool->allocate(bytes, DEFAULT_ALIGNMENT));
+		if (block == nullptr)
+			return nullptr;
+		block->next = next;
+		block->bytes = bytes;
+		reservedBytes += bytes;
+		if (current)
+			current->next = block;
+		else
+			first = block;
+		next = block;
+	}
+	current = next;
+	pos = current->begin();
+	end = current->end();
+	return allocate(size, alignment);
+}
+
+// @brief 原地调整已配置块的大小
+//     块紧挨着配置位置（最近一次配置的）时移动配置位置，当前块放得下就成功
+//     其余块只能缩小（多出的部分随 rewind/reset 一起回收）
+bool MemArena::tryExpand(void* address, ssize_t oldSize, ssize_t newSize) {
+	auto* begin = reinterpret_cast<uint8_t*>(address);
+	if (begin + oldSize == pos) {
+		if (end - begin < newSize)
+			return false;
+		pos = begin + newSize;
+		return true;
+	}
+	return newSize <= oldSize;
+}
+
+// @brief 记录当前位置
+MemArena::Checkpoint MemArena::checkpoint() const {
+	return {current, pos};
+}
+
+// @brief 回退到 cp 记录的位置，O(1)
+// cp 之后配置的内存全部作废，对应的块留给之后的配置复用
+void MemArena::rewind(const Checkpoint& cp) {
+	current = reinterpret_cast<Block*>(cp.block);
+	pos = cp.pos;
+	end = current ? current->end() : nullptr;
+}
+
+// @brief 清空，O(1)；块不还给内存池
+void MemArena::reset() {
+	rewind({nullptr, nullptr});
+}
+
+// @brief 清空并把所有块还给内存池
+void MemArena::release() {
+	for (Block* block = first; block; ) {
+		Block* next = block->next;
+		pool->deallocate(reinterpret_cast<uint8_t*>(block), block->bytes, DEFAULT_ALIGNMENT);
+		block = next;
+	}
+	first = current = nullptr;
+	pos = end = nullptr;
+	reservedBytes = 0;
+}
+
+MemPool* MemArena::getPool() const noexcept {
+	return pool;
+}
+
+ssize_t MemArena::getBlockSize() const noexcept {
+	return blockSize;
+}
+
+ssize_t MemArena::getReservedBytes() const noexcept {
+	return reservedBytes;
+}
@@ -26,7 +26,7 @@ MemList::MemList(void* pos, ssize_t size): maxSize(size), beginSize(size) {
 //      - safe:   地址全部被归还，一次性清空
 //      - unsafe: 地址部分被归还，遍历链表清空（Warning）
 MemList::~MemList() {
-    if (head->size < beginSize) {
+    if (head && head->size < beginSize) {
         std::cout << "\033[33;1mWarning\033[0m: some memory still not reclaimed (in MemList destructors)" << std::endl;
 	}
 }
@@ -46,6 +46,62 @@ MemList::~MemList() {
     std::cout << "+-----------------------------+" << std::endl << std::endl;
 }
 
+// @brief 从节点 p 中切出 [at, at + size)
+// 前面剩下的部分仍是节点 p，后面剩下的部分（为 0 或能保存一个空闲节点）作为新节点接在 p 之后
+// 两部分都比原来的 p 小，只有 p 原本是最大节点时才需要重新扫描 maxSize
+// @return at
+void* MemList::carve(MemListNode *p, uint8_t *at, ssize_t size) {
+    bool wasMax = p->size == maxSize;
+    ssize_t tail = (uint8_t *)p->getAddress() + p->size - (at + size);
+    p->size = at - (uint8_t *)p->getAddress();
+    if (tail > 0) {
+        auto *node = reinterpret_cast<MemListNode*>(at + size);
+        new(node) MemListNode(tail, p->next);
+        p->next = node;
+    }
+    if (wasMax)
+        resetMaxSize();
+    return at;
+}
+
+// @brief 原地调整已配置块的大小
+//      - 缩小: 多出的尾部（至少能保存一个空闲节点）按归还处理
+//      - 扩大: 紧跟在块后的空闲节点够大就从它的前部切走，剩余部分为 0 或能保存一个空闲节点
+// @parma address 块首地址
+// @return 是否调整成功（失败时链表不变）
+bool MemList::tryExpand(uint8_t *address, ssize_t oldSize, ssize_t newSize) {
+    if (newSize <= oldSize) {
+        if (newSize == oldSize)
+            return true;
+        if (oldSize - newSize < (ssize_t)sizeof(MemListNode))
+            return false;
+        deallocate(address + newSize, oldSize - newSize);
+        return true;
+    }
+    ssize_t delta = newSize - oldSize;
+    uint8_t *end = address + oldSize;
+    MemListNode *p = head;
+    while (p->next && (uint8_t *)p->next->getAddress() < end)
+        p = p->next;
+    MemListNode *next = p->next;
+    if (next == nullptr || (uint8_t *)next->getAddress() != end)
+        return false;
+    ssize_t remain = next->size - delta;
+    if (remain != 0 && remain < (ssize_t)sizeof(MemListNode))
+        return false;
+    bool wasMax = next->size == maxSize;
+    MemListNode *after = next->next;
+    if (remain == 0) {
+        p->next = after;
+    } else {
+        p->next = reinterpret_cast<MemListNode*>(end + delta);
+        new(p->next) MemListNode(remain, after);
+    }
+    if (wasMax)
+        resetMaxSize();
+    return true;
+}
+
 // @brief 内存归还
 //      情况：
 //        - 1.可与前面合并
@@ -55,32 +111,69 @@ MemList::~MemList() {
 // @parma address   归还首地址
 // @parma size      归还大小
 void MemList::deallocate(uint8_t *address, ssize_t size) {
+    insertFrom(head, address, size);
+}
+
+// @brief 批量归还（blocks 按地址升序）
+// 每块都从上一块插入的位置接着向后找，整批只遍历链表一遍
+void MemList::deallocateSorted(const std::pair<uint8_t*, ssize_t> *blocks, int count) {
     MemListNode *p = head;
-    while (p) {
-        if ((p->next && address < p->next->getAddress()) || !p->next) { // 在 p 后面插入
-            if ((uint8_t *)p->getAddress() + p->size == address) {          // 情况1
-                p->size += size;
-                if (p->next && address + size == p->next->getAddress()) {   // 情况2
-                    p->size += p->next->size;
-                    p->next = p->next->next;
-                }
-                maxSize = std::max(maxSize, p->size);
-            } else if (p->next && address + size == p->next->getAddress()) {// 情况3
-                ssize_t beforeNextSize = p->next->getSize();
-                MemListNode* beforeNextNext = p->next->next;
-                p->next = (MemListNode*)address;
-                new(p->next) MemListNode(beforeNextSize + size, beforeNextNext);
-                maxSize = std::max(maxSize, beforeNextSize + size);
-            } else {                                                        // 情况4
-                MemListNode* nextBefore = p->next;
-                // 同理 placement new
-                p->next = reinterpret_cast<MemListNode*>(address);
-                new(p->next) MemListNode(size, nextBefore);
-                maxSize = std::max(maxSize, size);
-            }
-            return;
-        }
+    for (int i = 0; i < count; i ++)
+        p = insertFrom(p, blocks[i].first, blocks[i].second);
+}
+
+// @brief 从节点 p 开始向后找到 address 的插入位置，插入并与前后合并
+// @parma p 地址不大于 address 的节点
+// @return 插入后覆盖 address 的节点（地址递增地归还时，下一块从它开始找）
+MemListNode* MemList::insertFrom(MemListNode *p, uint8_t *address, ssize_t size) {
+    while (p->next && address >= (uint8_t *)p->next->getAddress())
         p = p->next;
+    // 在 p 后面插入
+    if ((uint8_t *)p->getAddress() + p->size == address) {          // 情况1
+        p->size += size;
+        if (p->next && address + size == p->next->getAddress()) {   // 情况2
+            p->size += p->next->size;
+            p->next = p->next->next;
+        }
+        maxSize = std::max(maxSize, p->size);
+        return p;
+    } else if (p->next && address + size == p->next->getAddress()) {// 情况3
+        ssize_t beforeNextSize = p->next->getSize();
+        MemListNode* beforeNextNext = p->next->next;
+        p->next = (MemListNode*)address;
+        new(p->next) MemListNode(beforeNextSize + size, beforeNextNext);
+        maxSize = std::max(maxSize, beforeNextSize + size);
+    } else {                                                        // 情况4
+        MemListNode* nextBefore = p->next;
+        // 同理 placement new
+        p->next = reinterpret_cast<MemListNode*>(address);
+        new(p->next) MemListNode(size, nextBefore);
+        maxSize = std::max(maxSize, size);
+    }
+    return p->next;
+}
+
+// @brief 重置为整块空闲
+// 管理的内存内容已被丢弃（如 madvise 之后）时用来重建链表
+void MemList::reset() {
+    head = reinterpret_cast<MemListNode*>(beginPos);
+    new(head) MemListNode(beginSize, nullptr);
+    maxSize = beginSize;
+}
+
+// @brief 是否已全部归还
+// 头结点始终位于 beginPos（配置只从节点尾部切），全空闲时它就是唯一的节点
+bool MemList::isFree() const {
+    return head->size == beginSize;
+}
+
+// @brief 统计空闲块数、空闲字节数与最大空闲块（调用方持有 lock）
+void MemList::freeStats(MemListStats &stats) const {
+    stats.freeBlocks = stats.freeBytes = stats.largestFreeBlock = 0;
+    for (MemListNode *p = head; p; p = p->next) {
+        stats.freeBlocks ++;
+        stats.freeBytes += p->size;
+        stats.largestFreeBlock = std::max(stats.largestFreeBlock, p->size);
     }
 }
 
@@ -93,4 +186,33 @@ void MemList::resetMaxSize() {
         this->maxSize = std::max(this->maxSize, p->size);
         p = p->next;
     }
+}
+
+// @brief 无锁压入待归还栈（多生产者，单次 CAS）
+// 块的前部就地构造一个链表节点记下大小，块本身不小于 sizeof(MemListNode)
+// @parma address   归还首地址
+// @parma size      归还大小
+void MemList::pushPending(uint8_t *address, ssize_t size) {
+    auto* node = new(address) MemListNode(size, pending.load(std::memory_order_relaxed));
+    while (!pending.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+}
+
+// @brief 一次取走整个待归还栈，逐块归还并合并（调用方持有 lock）
+// 整栈交换出来，不会有 ABA 问题
+// @return 是否有待归还的块
+bool MemList::drainPending() {
+    MemListNode *p = pending.exchange(nullptr, std::memory_order_acquire);
+    if (p == nullptr)
+        return false;
+    while (p) {
+        MemListNode *next = p->next;
+        deallocate(reinterpret_cast<uint8_t*>(p), p->size);
+        p = next;
+    }
+    return true;
+}
+
+// @brief 是否有待归还的块
+bool MemList::hasPending() const {
+    return pending.load(std::memory_order_relaxed) != nullptr;
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "memlist_bf.h"
+#include "memlist_policy.h"
 
 void *MemList_BF::allocate(ssize_t size) {
     MemListNode *p = head;
@@ -20,4 +21,15 @@ void *MemList_BF::allocate(ssize_t size) {
         resetMaxSize();
         return (uint8_t *)retNode->getAddress() + retNode->size;
     }
-}
\ No newline at end of file
+}
+
+// @brief 按 alignment 对齐的空间分配：能切出对齐位置的节点中最小的
+void *MemList_BF::allocateAligned(ssize_t size, ssize_t alignment) {
+    MemListNode *retNode = nullptr;
+    for (MemListNode *p = head; p; p = p->next) {
+        if ((!retNode || p->size < retNode->size) && zyz::alignedSpot(p, size, alignment))
+            retNode = p;
+    }
+    if (retNode == nullptr) return nullptr;
+    return carve(retNode, zyz::alignedSpot(retNode, size, alignment), size);
+}
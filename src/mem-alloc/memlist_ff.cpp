@@ -1,4 +1,5 @@
 #include "memlist_ff.h"
+#include "memlist_policy.h"
 
 // @brief 空间分配函数
 // @parma size 需要分配的空间大小
@@ -18,3 +19,11 @@ void* MemList_FF::allocate(ssize_t size) {
     return nullptr;
 }
 
+// @brief 按 alignment 对齐的空间分配：第一个能切出对齐位置的节点
+void* MemList_FF::allocateAligned(ssize_t size, ssize_t alignment) {
+    for (MemListNode *p = head; p; p = p->next) {
+        if (uint8_t *at = zyz::alignedSpot(p, size, alignment))
+            return carve(p, at, size);
+    }
+    return nullptr;
+}
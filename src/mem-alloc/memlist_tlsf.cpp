@@ -0,0 +1,313 @@
+#include "memlist_tlsf.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+// 最高位 1 的下标（x != 0）
+static inline int tlsf_fls (uint64_t x) {
+    return 63 - __builtin_clzll(x);
+}
+
+// 最低位 1 的下标（x != 0）
+static inline int tlsf_ffs (uint64_t x) {
+    return __builtin_ctzll(x);
+}
+
+// @brief 构造函数
+// @parma pos   内存块首地址（nullptr 则新开辟）
+// @parma size  内存块大小
+MemList_TLSF::MemList_TLSF(void* pos, ssize_t size) : MemList(pos, size) {
+    reset();
+}
+
+// @brief 析构函数
+// 只有首块空闲且紧挨哨兵时才说明全部归还
+MemList_TLSF::~MemList_TLSF() {
+    if (!isFree()) {
+        std::cout << "\033[33;1mWarning\033[0m: some memory still not reclaimed (in MemList_TLSF destructors)" << std::endl;
+    }
+}
+
+// @brief 重置为整块空闲
+// 整段内存组织为：一个空闲大块 + 末尾一个大小为 0 的已分配哨兵块
+// 哨兵块让最后一个空闲块合并时不会越界
+void MemList_TLSF::reset() {
+    flBitmap = 0;
+    for (int i = 0; i < FL_INDEX_COUNT; i ++) {
+        slBitmap[i] = 0;
+        for (int j = 0; j < SL_INDEX_COUNT; j ++)
+            blocks[i][j] = nullptr;
+    }
+    auto begin = ((uintptr_t)beginPos + ALIGN_SIZE - 1) & ~(uintptr_t)(ALIGN_SIZE - 1);
+    auto end = ((uintptr_t)beginPos + beginSize) & ~(uintptr_t)(ALIGN_SIZE - 1);
+    firstSize = (ssize_t)(end - begin) - 2 * HEADER_SIZE;
+    if (end < begin || firstSize < BLOCK_MIN_SIZE) {
+        std::cout << "Error: too small to be tlsf-list (in construct of MemList_TLSF)" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    // 不使用基类的单链表
+    head = nullptr;
+
+    first = reinterpret_cast<Block*>(begin);
+    first->prevPhys = nullptr;
+    first->size = firstSize;
+    Block* sentinel = first->nextPhys();
+    sentinel->prevPhys = first;
+    sentinel->size = 0;
+    insertFree(first);
+    updateMaxSize();
+}
+
+// @brief 是否已全部归还
+bool MemList_TLSF::isFree() const {
+    return first->isFree() && first->getSize() == firstSize;
+}
+
+// @brief 按物理顺序统计空闲块（调用方持有 lock）
+void MemList_TLSF::freeStats(MemListStats &stats) const {
+    stats.freeBlocks = stats.freeBytes = stats.largestFreeBlock = 0;
+    for (Block* p = first; p->getSize(); p = p->nextPhys()) {
+        if (p->isFree()) {
+            stats.freeBlocks ++;
+            stats.freeBytes += p->getSize();
+            stats.largestFreeBlock = std::max(stats.largestFreeBlock, p->getSize());
+        }
+    }
+}
+
+// @brief 链表打印
+// 按物理顺序打印所有空闲块，表头：|-空闲块首地址-|-空闲块大小-|
+void MemList_TLSF::print() const {
+    std::cout.setf(std::ios::left);
+    std::cout << "+-----------------------------+" << std::endl;
+    std::cout << "|  " << std::setw(16) << "Address" << "| " << std::setw(9) << "size" << "|" << std::endl;
+    std::cout << "+-----------------------------+" << std::endl;
+    for (Block* p = first; p->getSize(); p = p->nextPhys()) {
+        if (p->isFree())
+            std::cout << "|  " << std::setw(16) << (void*)p->payload() << "| " << std::setw(9) << p->getSize() << "|" << std::endl;
+    }
+    std::cout << "+-----------------------------+" << std::endl << std::endl;
+}
+
+// @brief 大小到桶的映射（插入用，向下取桶）
+void MemList_TLSF::mappingInsert(ssize_t size, int& fl, int& sl) {
+    if (size < SMALL_BLOCK_SIZE) {
+        fl = 0;
+        sl = (int)(size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT));
+    } else {
+        int f = tlsf_fls(size);
+        sl = (int)(size >> (f - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+        fl = f - (FL_INDEX_SHIFT - 1);
+    }
+}
+
+// @brief 大小到桶的映射（查找用，向上取桶，保证桶内任意块都够用）
+void MemList_TLSF::mappingSearch(ssize_t size, int& fl, int& sl) {
+    if (size >= SMALL_BLOCK_SIZE)
+        size += ((ssize_t)1 << (tlsf_fls(size) - SL_INDEX_COUNT_LOG2)) - 1;
+    mappingInsert(size, fl, sl);
+}
+
+// @brief 桶 (fl, sl) 中块大小的下界
+ssize_t MemList_TLSF::bucketLowerBound(int fl, int sl) {
+    if (fl == 0)
+        return sl * (SMALL_BLOCK_SIZE / SL_INDEX_COUNT);
+    int f = fl + FL_INDEX_SHIFT - 1;
+    return ((ssize_t)1 << f) + sl * ((ssize_t)1 << (f - SL_INDEX_COUNT_LOG2));
+}
+
+// @brief 从 (fl, sl) 开始找第一个非空桶
+// @return 找到则返回链表头并把 fl, sl 改为该桶，否则 nullptr
+MemList_TLSF::Block* MemList_TLSF::searchSuitable(int& fl, int& sl) const {
+    uint32_t slMap = slBitmap[fl] & (~0u << sl);
+    if (!slMap) {
+        uint64_t flMap = fl + 1 < 64 ? flBitmap & (~0ull << (fl + 1)) : 0;
+        if (!flMap)
+            return nullptr;
+        fl = tlsf_ffs(flMap);
+        slMap = slBitmap[fl];
+    }
+    sl = tlsf_ffs(slMap);
+    return blocks[fl][sl];
+}
+
+// @brief 空闲块放进对应桶的链表头，并置位图
+void MemList_TLSF::insertFree(Block* block) {
+    int fl, sl;
+    mappingInsert(block->getSize(), fl, sl);
+    Block* current = blocks[fl][sl];
+    block->size |= 1;
+    block->nextFree = current;
+    block->prevFree = nullptr;
+    if (current)
+        current->prevFree = block;
+    blocks[fl][sl] = block;
+    flBitmap |= 1ull << fl;
+    slBitmap[fl] |= 1u << sl;
+}
+
+// @brief 空闲块从所在桶的链表中摘下，桶空了就清位图
+void MemList_TLSF::removeFree(Block* block) {
+    int fl, sl;
+    mappingInsert(block->getSize(), fl, sl);
+    if (block->prevFree)
+        block->prevFree->nextFree = block->nextFree;
+    else
+        blocks[fl][sl] = block->nextFree;
+    if (block->nextFree)
+        block->nextFree->prevFree = block->prevFree;
+    block->size &= ~(ssize_t)1;
+    if (!blocks[fl][sl]) {
+        slBitmap[fl] &= ~(1u << sl);
+        if (!slBitmap[fl])
+            flBitmap &= ~(1ull << fl);
+    }
+}
+
+// @brief 更新最大可用空间
+// 取最高非空桶的下界：它不超过真实最大块，但保证 allocate(maxSize) 一定成功
+void MemList_TLSF::updateMaxSize() {
+    if (!flBitmap) {
+        maxSize = 0;
+        return;
+    }
+    int fl = tlsf_fls(flBitmap);
+    maxSize = bucketLowerBound(fl, tlsf_fls(slBitmap[fl]));
+}
+
+// @brief 空间分配函数
+//     向上取桶后用位图 O(1) 找到非空桶，取出其中的块
+//     剩余部分足够再放一个块头和空闲指针就切出来放回去
+// @parma size 需要分配的空间大小
+// @return
+//   - not nullptr:  分配到的负载首地址
+//   - nullptr:      没有足够大的空闲块
+void* MemList_TLSF::allocate(ssize_t size) {
+    if (size > beginSize)
+        return nullptr;
+    size = (std::max(size, BLOCK_MIN_SIZE) + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+    int fl, sl;
+    mappingSearch(size, fl, sl);
+    if (fl >= FL_INDEX_COUNT)
+        return nullptr;
+    Block* block = searchSuitable(fl, sl);
+    if (!block)
+        return nullptr;
+    removeFree(block);
+    trimTail(block, size);
+    updateMaxSize();
+    return block->payload();
+}
+
+// @brief 按 alignment 对齐的空间分配
+//     多找 alignment + HEADER_SIZE + BLOCK_MIN_SIZE 的块，负载前面不对齐的部分
+//     （为 0 或至少能放下一个空闲块）切成独立的空闲块放回去，新块头紧挨在对齐位置之前
+// @parma alignment 2 的幂次
+void* MemList_TLSF::allocateAligned(ssize_t size, ssize_t alignment) {
+    if (alignment <= ALIGN_SIZE)
+        return allocate(size);
+    if (size > beginSize)
+        return nullptr;
+    size = (std::max(size, BLOCK_MIN_SIZE) + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+    int fl, sl;
+    mappingSearch(size + alignment + HEADER_SIZE + BLOCK_MIN_SIZE, fl, sl);
+    if (fl >= FL_INDEX_COUNT)
+        return nullptr;
+    Block* block = searchSuitable(fl, sl);
+    if (!block)
+        return nullptr;
+    removeFree(block);
+
+    auto payload = (uintptr_t)block->payload();
+    auto aligned = (payload + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (aligned != payload && aligned - payload < HEADER_SIZE + BLOCK_MIN_SIZE)
+        aligned = (payload + HEADER_SIZE + BLOCK_MIN_SIZE + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (aligned != payload) {
+        auto gap = (ssize_t)(aligned - payload);
+        auto* moved = reinterpret_cast<Block*>(aligned - HEADER_SIZE);
+        moved->prevPhys = block;
+        moved->size = block->getSize() - gap;
+        moved->nextPhys()->prevPhys = moved;
+        block->size = gap - HEADER_SIZE;
+        insertFree(block);
+        block = moved;
+    }
+    trimTail(block, size);
+    updateMaxSize();
+    return block->payload();
+}
+
+// @brief 已摘下的块只留 size，剩余部分足够再放一个块头和空闲指针就切出来放回去
+void MemList_TLSF::trimTail(Block* block, ssize_t size) {
+    if (block->getSize() >= size + HEADER_SIZE + BLOCK_MIN_SIZE) {
+        auto* remain = reinterpret_cast<Block*>(block->payload() + size);
+        remain->prevPhys = block;
+        remain->size = block->getSize() - size - HEADER_SIZE;
+        remain->nextPhys()->prevPhys = remain;
+        block->size = size;
+        insertFree(remain);
+    }
+}
+
+// @brief 内存归还
+//     由块头找到物理前驱与后继，空闲的就摘下来合并，最后整块放回桶中
+// @parma address   归还首地址（allocate 返回的负载地址）
+// @parma size      归还大小（块头中已有记录，此处不使用）
+void MemList_TLSF::deallocate(uint8_t *address, ssize_t /*size*/) {
+    auto* block = reinterpret_cast<Block*>(address - HEADER_SIZE);
+    Block* prev = block->prevPhys;
+    if (prev && prev->isFree()) {
+        removeFree(prev);
+        prev->size += HEADER_SIZE + block->getSize();
+        block = prev;
+        block->nextPhys()->prevPhys = block;
+    }
+    Block* next = block->nextPhys();
+    if (next->isFree()) {
+        removeFree(next);
+        block->size += HEADER_SIZE + next->getSize();
+        block->nextPhys()->prevPhys = block;
+    }
+    insertFree(block);
+    updateMaxSize();
+}
+
+// @brief 批量归还：块头记录了物理邻居，每块的合并都是 O(1)，不需要利用有序性
+void MemList_TLSF::deallocateSorted(const std::pair<uint8_t*, ssize_t> *blocks, int count) {
+    for (int i = 0; i < count; i ++)
+        deallocate(blocks[i].first, blocks[i].second);
+}
+
+// @brief 原地调整已配置块的大小
+//     扩大时物理后继空闲且合起来够大就把它并进来；多出来的尾部切下来与后继空闲块合并后放回
+// @parma address 块的负载首地址
+// @parma oldSize 原大小（块头中已有记录，此处不使用）
+// @return 是否调整成功（失败时不做任何修改）
+bool MemList_TLSF::tryExpand(uint8_t *address, ssize_t /*oldSize*/, ssize_t newSize) {
+    auto* block = reinterpret_cast<Block*>(address - HEADER_SIZE);
+    newSize = (std::max(newSize, BLOCK_MIN_SIZE) + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+    if (newSize > block->getSize()) {
+        Block* next = block->nextPhys();
+        if (!next->isFree() || block->getSize() + HEADER_SIZE + next->getSize() < newSize)
+            return false;
+        removeFree(next);
+        block->size += HEADER_SIZE + next->getSize();
+        block->nextPhys()->prevPhys = block;
+    }
+    if (block->getSize() >= newSize + HEADER_SIZE + BLOCK_MIN_SIZE) {
+        auto* remain = reinterpret_cast<Block*>(block->payload() + newSize);
+        remain->prevPhys = block;
+        remain->size = block->getSize() - newSize - HEADER_SIZE;
+        block->size = newSize;
+        Block* next = remain->nextPhys();
+        if (next->isFree()) {
+            removeFree(next);
+            remain->size += HEADER_SIZE + next->getSize();
+        }
+        remain->nextPhys()->prevPhys = remain;
+        insertFree(remain);
+    }
+    updateMaxSize();
+    return true;
+}
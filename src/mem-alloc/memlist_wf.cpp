@@ -1,4 +1,6 @@
 #include "memlist_wf.h"
+#include "memlist_policy.h"
+
 void *MemList_WF::allocate(ssize_t size) {
     MemListNode *p = head;
     int mxSize = -1;
@@ -21,5 +23,13 @@ void *MemList_WF::allocate(ssize_t size) {
     }
 }
 
-
-
+// @brief 按 alignment 对齐的空间分配：能切出对齐位置的节点中最大的
+void *MemList_WF::allocateAligned(ssize_t size, ssize_t alignment) {
+    MemListNode *retNode = nullptr;
+    for (MemListNode *p = head; p; p = p->next) {
+        if ((!retNode || p->size > retNode->size) && zyz::alignedSpot(p, size, alignment))
+            retNode = p;
+    }
+    if (retNode == nullptr) return nullptr;
+    return carve(retNode, zyz::alignedSpot(retNode, size, alignment), size);
+}
@@ -2,49 +2,239 @@
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
 
 // @brief 内存池初始化
 // @parma _nLists 空闲链表数量
 //    新建 _nLists 个空闲链表, 每个空闲链表可用空间大小为 _oneSize
+//    开启扩容（_options.chunkLists > 0）时初始块也用 mmap 映射，以便使用大页
 //    - _nLists*_oneSize is too big: failure
 //    - else:						 successful
-MemPool::MemPool(ssize_t _nLists, ssize_t _oneSize, int alloc_algorithm) :
-		lists(new MemList*[_nLists]),
-		sizeLists(_nLists),
-		oneListSize(_oneSize) {
+MemPool::MemPool(ssize_t _nLists, ssize_t _oneSize, int alloc_algorithm, const MemPoolOptions& _options) :
+		sizeLists(0),
+		oneListSize(_oneSize),
+		residentFreeChunks(0),
+		options(_options),
+		largeThreshold(_options.largeThreshold),
+		algorithm(alloc_algorithm),
+		capacity(_nLists, alloc_algorithm == BEST_FIT),
+		slabs(this),
+		useSlabs(_oneSize >= SlabCache::SLAB_SIZE + 2 * SlabCache::SLAB_ALIGN + 2 * (ssize_t)sizeof(MemListNode)) {
 	std::set_new_handler(nullptr);
-	beginPos = new uint8_t[_nLists * _oneSize];
+	ssize_t bytes = _nLists * _oneSize;
+	bool mapped = options.chunkLists > 0;
+	beginPos = mapped ? mapChunk(bytes) : new uint8_t[bytes];
 	if (beginPos == nullptr) {
 		std::cout << "Error: out of memory(in construct of MemPool)" << std::endl;
 		exit(EXIT_FAILURE);
 	}
-	for (int i = 0; i < _nLists; i ++) {
-		// 虽然 lists_1, list_2, ... 连续，但是 list_1.head, list_2.head, ... 不连续
-		if (alloc_algorithm == FIRST_FIT)
-			lists[i] = new MemList_FF(beginPos + i * _oneSize, _oneSize);
-		else if (alloc_algorithm == BEST_FIT)
-			lists[i] = new MemList_BF(beginPos + i * _oneSize, _oneSize);
-		else
-			lists[i] = new MemList_WF(beginPos + i * _oneSize, _oneSize);
-	}
+	addChunk(beginPos, bytes, mapped, true);
+	// 默认阈值取链表大小的一半，但不小于一页，避免小于一页的请求独占整页
+	if (largeThreshold == 0)
+		largeThreshold = std::max(_oneSize / 2, (ssize_t)sysconf(_SC_PAGESIZE));
 }
 
 // @brief 内存池析构
-// 对size个空闲链表清空，再释放这个指针数组
+// 先收回 slab 页，再对size个空闲链表清空，最后释放各块与这个指针数组
 MemPool::~MemPool() {
+	ThreadCache::detach(this);
+	if (!largeObjects.empty()) {
+		std::cout << "\033[33;1mWarning\033[0m: some large objects still not reclaimed (in MemPool destructors)" << std::endl;
+		for (auto& [address, bytes] : largeObjects)
+			munmap(address, bytes);
+	}
+	slabs.release();
 	for (int i = 0; i < sizeLists; i ++) {
+		lists[i]->drainPending();
 		delete lists[i];
 	}
-	delete[] beginPos;
-	delete[] lists;
+	for (MemChunk* chunk : chunks) {
+		if (chunk->mapped)
+			munmap(chunk->base, chunk->bytes);
+		else
+			delete[] chunk->base;
+		delete chunk;
+	}
+}
+
+// @brief 用 mmap 映射一段匿名内存
+// @parma bytes 期望大小，返回时改为实际映射大小（按页或大页向上取整）
+// @return 首地址，失败为 nullptr
+uint8_t* MemPool::mapChunk(ssize_t &bytes) const {
+	void* pos = MAP_FAILED;
+#ifdef MAP_HUGETLB
+	if (options.hugePage == MemPoolOptions::HUGE_PAGE_EXPLICIT) {
+		const ssize_t hugeSize = 2 << 20;
+		ssize_t hugeBytes = (bytes + hugeSize - 1) / hugeSize * hugeSize;
+		pos = mmap(nullptr, hugeBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (pos != MAP_FAILED)
+			bytes = hugeBytes;
+	}
+#endif
+	if (pos == MAP_FAILED) {
+		ssize_t pageSize = sysconf(_SC_PAGESIZE);
+		bytes = (bytes + pageSize - 1) / pageSize * pageSize;
+		pos = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (pos == MAP_FAILED)
+			return nullptr;
+#ifdef MADV_HUGEPAGE
+		// 显式大页不可用时也退回透明大页
+		if (options.hugePage != MemPoolOptions::HUGE_PAGE_NONE)
+			madvise(pos, bytes, MADV_HUGEPAGE);
+#endif
+	}
+	return reinterpret_cast<uint8_t*>(pos);
+}
+
+// @brief 按分配算法在 pos 处新建一张链表
+MemList* MemPool::createList(uint8_t *pos) const {
+	if (algorithm == FIRST_FIT)
+		return new MemList_FF(pos, oneListSize);
+	else if (algorithm == BEST_FIT)
+		return new MemList_BF(pos, oneListSize);
+	else if (algorithm == TLSF_FIT)
+		return new MemList_TLSF(pos, oneListSize);
+	else
+		return new MemList_WF(pos, oneListSize);
+}
+
+// @brief 把一块内存切成 bytes / oneListSize 张链表加入内存池
+//     新链表按首地址插入，保持 lists 有序以便 deallocate 二分查找
+void MemPool::addChunk(uint8_t *base, ssize_t bytes, bool mapped, bool pinned) {
+	auto* chunk = new MemChunk{base, bytes, 0, mapped, pinned, false};
+	chunks.push_back(chunk);
+	auto pos = std::upper_bound(lists.begin(), lists.end(), base, [](uint8_t* address, MemList* list) {
+		return address < reinterpret_cast<uint8_t*>(list->beginPos);
+	}) - lists.begin();
+	ssize_t n = bytes / oneListSize;
+	for (int i = 0; i < n; i ++) {
+		// 虽然 lists_1, list_2, ... 连续，但是 list_1.head, list_2.head, ... 不连续
+		lists.insert(lists.begin() + pos + i, createList(base + i * oneListSize));
+		listChunks.insert(listChunks.begin() + pos + i, chunk);
+	}
+	sizeLists = (ssize_t)lists.size();
+	rebuildCapacity();
+	if (!pinned)
+		residentFreeChunks ++;
+}
+
+// @brief 映射一个新块扩容（独占 _structMutex）
+//     等待独占锁期间别的线程可能已经扩过容或归还了块，先看现有链表是否已经放得下
+// @parma need 需要的链表容量
+// @return 是否有链表放得下 need
+bool MemPool::grow(ssize_t need) {
+	std::unique_lock<std::shared_mutex> structure(_structMutex);
+	if (capacity.firstFit(need) != -1)
+		return true;
+	ssize_t bytes = options.chunkLists * oneListSize;
+	uint8_t* base = mapChunk(bytes);
+	if (base == nullptr)
+		return false;
+	addChunk(base, bytes, true, false);
+	// TLSF 的容量是桶下界，比 oneListSize 小，接近 oneListSize 的请求新链表也放不下
+	return capacity.firstFit(need) != -1;
+}
+
+// @brief 归还一个全空闲的扩容块（独占 _structMutex）
+//     由 updateList 发现后在所有锁之外调用，拿到独占锁时块可能已被重新使用或已归还，需重新确认
+//     - unmapRelease: 摘掉其中的链表后 munmap
+//     - else:         madvise 丢弃物理页，链表重建后继续使用
+void MemPool::releaseChunk(MemChunk *chunk) {
+	std::unique_lock<std::shared_mutex> structure(_structMutex);
+	if (std::find(chunks.begin(), chunks.end(), chunk) == chunks.end() || chunk->busyLists != 0
+			|| chunk->advised || residentFreeChunks <= options.retainChunks)
+		return;
+	residentFreeChunks --;
+	auto first = std::lower_bound(lists.begin(), lists.end(), chunk->base, [](MemList* list, uint8_t* address) {
+		return reinterpret_cast<uint8_t*>(list->beginPos) < address;
+	}) - lists.begin();
+	auto last = first;
+	while (last < sizeLists && listChunks[last] == chunk)
+		last ++;
+	if (options.unmapRelease) {
+		for (auto i = first; i < last; i ++)
+			delete lists[i];
+		lists.erase(lists.begin() + first, lists.begin() + last);
+		listChunks.erase(listChunks.begin() + first, listChunks.begin() + last);
+		sizeLists = (ssize_t)lists.size();
+		chunks.erase(std::find(chunks.begin(), chunks.end(), chunk));
+		munmap(chunk->base, chunk->bytes);
+		delete chunk;
+		rebuildCapacity();
+	} else {
+		madvise(chunk->base, chunk->bytes, MADV_DONTNEED);
+		for (auto i = first; i < last; i ++)
+			lists[i]->reset();
+		chunk->advised = true;
+	}
+}
+
+// @brief 链表数量变化后重建容量树
+void MemPool::rebuildCapacity() {
+	capacity.resize(sizeLists);
+	for (int i = 0; i < sizeLists; i ++)
+		capacity.update(i, lists[i]->maxSize);
+}
+
+// @brief 第 i 张链表被修改后调用（调用方持有该链表的锁）
+//     在 _mutex 下更新容量树；开启扩容时维护所属块的空闲状态
+// @parma wasFree 修改前链表是否全空闲
+// @return 超出保留数量、应当归还系统的全空闲块，调用方释放所有锁后交给 releaseChunk；没有则为 nullptr
+MemPool::MemChunk* MemPool::updateList(int i, bool wasFree) {
+	std::lock_guard<std::mutex> guard(_mutex);
+	capacity.update(i, lists[i]->maxSize);
+	if (options.chunkLists <= 0)
+		return nullptr;
+	bool nowFree = lists[i]->isFree();
+	MemChunk* chunk = listChunks[i];
+	if (wasFree == nowFree || chunk->pinned)
+		return nullptr;
+	if (!nowFree) {
+		if (chunk->busyLists ++ == 0) {
+			if (chunk->advised)
+				chunk->advised = false;
+			else
+				residentFreeChunks --;
+		}
+	} else if (-- chunk->busyLists == 0) {
+		residentFreeChunks ++;
+		if (residentFreeChunks > options.retainChunks)
+			return chunk;
+	}
+	return nullptr;
 }
 
 // @brief 内存回归函数
-//     先二分查到 address 属于哪个空闲链表
-//     然后调用对应空闲链表的 deallocate 函数进行回收
+//     小对象还给 slab 层
+//     其余先二分查到 address 属于哪个空闲链表，只锁这一张链表调用它的 deallocate 进行回收
+//     链表正被占用时不等待，无锁压入它的待归还栈
 // @parma size	  回归大小
 // @parma address 回归首地址
-void MemPool::deallocate(uint8_t *address, ssize_t _size) {
+// @parma alignment 与配置时一致（决定走哪一层）
+void MemPool::deallocate(uint8_t *address, ssize_t _size, ssize_t alignment) {
+	if (MemProfiler* p = profiler.load(std::memory_order_relaxed)) [[unlikely]]
+		p->onFree(address);
+	counters.onFree(_size);
+	if (largeThreshold != -1 && _size >= largeThreshold) {
+		deallocateLarge(address);
+		return;
+	}
+	int cls = slabClass(_size, alignmentFor(_size, alignment));
+	if (cls != -1) {
+		std::lock_guard<std::mutex> guard(_slabMutex);
+		slabs.deallocate(cls, address);
+		return;
+	}
+	deallocateFromLists(address, _size);
+}
+
+// @brief 二分查找 address 属于哪个空闲链表（调用方持有 _structMutex）
+// @return 链表下标
+int MemPool::findList(uint8_t *address) const {
 	int l = 0, r = (int)this->sizeLists - 1, res = 0;
 	while (l < r) {
 		int mid = (l + r) >> 1;
@@ -60,15 +250,124 @@ void MemPool::deallocate(uint8_t *address, ssize_t _size) {
 	if (address >= reinterpret_cast<uint8_t*>(lists[r]->beginPos)) {
 		res = r;
 	}
-	// 修改内存池，加锁
-	_mutex.lock();
-	lists[res]->deallocate(address, _size);
-	_mutex.unlock();
+	return res;
+}
+
+// @brief 批量回收同样大小的 count 块，供线程缓存归还使用
+//     slab 层只加一次锁；其余交给 deallocateBatch 按地址排序后归并
+void MemPool::deallocateMany(void **blocks, int count, ssize_t _size, ssize_t alignment) {
+	int cls = slabClass(_size, alignmentFor(_size, alignment));
+	if (cls == -1) {
+		std::vector<ssize_t> sizes(count, _size);
+		freeBatch(blocks, sizes.data(), count, alignment);
+		return;
+	}
+	std::lock_guard<std::mutex> guard(_slabMutex);
+	for (int i = 0; i < count; i ++) {
+		counters.onFree(_size);
+		slabs.deallocate(cls, blocks[i]);
+	}
+}
+
+// @brief 批量内存回归
+//     大对象逐个解除映射，slab 层的块只加一次锁
+//     其余按地址排序后按所属链表分组，每张链表只加一次锁，一趟有序归并插回（见 MemList::deallocateSorted）
+// @parma blocks 各块首地址
+// @parma sizes  各块大小（与配置时一致）
+// @parma alignment 与配置时一致（决定走哪一层）
+void MemPool::deallocateBatch(void **blocks, const ssize_t *sizes, int count, ssize_t alignment) {
+	if (MemProfiler* p = profiler.load(std::memory_order_relaxed)) [[unlikely]] {
+		for (int i = 0; i < count; i ++)
+			p->onFree(blocks[i]);
+	}
+	freeBatch(blocks, sizes, count, alignment);
+}
+
+// @brief 批量回收的实现（不经过采样分析器，线程缓存归还时也走这里）
+void MemPool::freeBatch(void **blocks, const ssize_t *sizes, int count, ssize_t alignment) {
+	std::vector<std::pair<uint8_t*, ssize_t>> listed;
+	int slabbed = 0;
+	for (int i = 0; i < count; i ++) {
+		counters.onFree(sizes[i]);
+		if (largeThreshold != -1 && sizes[i] >= largeThreshold)
+			deallocateLarge((uint8_t *)blocks[i]);
+		else if (slabClass(sizes[i], alignmentFor(sizes[i], alignment)) != -1)
+			slabbed ++;
+		else
+			listed.emplace_back((uint8_t *)blocks[i], sizes[i]);
+	}
+	if (slabbed > 0) {
+		std::lock_guard<std::mutex> guard(_slabMutex);
+		for (int i = 0; i < count; i ++) {
+			if (largeThreshold != -1 && sizes[i] >= largeThreshold)
+				continue;
+			int cls = slabClass(sizes[i], alignmentFor(sizes[i], alignment));
+			if (cls != -1)
+				slabs.deallocate(cls, blocks[i]);
+		}
+	}
+	if (!listed.empty())
+		deallocateSortedToLists(listed);
+}
+
+// @brief 把一批块还给各自的链表
+//     排序后同一张链表的块连续，阻塞地锁住这张链表、合并待归还栈，再一趟插回这一组
+//     所属块因此变为可归还时，放掉全部锁后再归还
+void MemPool::deallocateSortedToLists(std::vector<std::pair<uint8_t*, ssize_t>> &blocks) {
+	std::sort(blocks.begin(), blocks.end());
+	std::vector<MemChunk*> release;
+	{
+		std::shared_lock<std::shared_mutex> structure(_structMutex);
+		for (size_t from = 0, to; from < blocks.size(); from = to) {
+			int i = findList(blocks[from].first);
+			auto* bound = i + 1 < sizeLists ? reinterpret_cast<uint8_t*>(lists[i + 1]->beginPos) : nullptr;
+			for (to = from + 1; to < blocks.size() && (bound == nullptr || blocks[to].first < bound); to ++);
+			MemList* list = lists[i];
+			list->lock.lock();
+			bool wasFree = options.chunkLists > 0 && list->isFree();
+			list->drainPending();
+			list->deallocateSorted(blocks.data() + from, (int)(to - from));
+			for (size_t k = from; k < to; k ++)
+				list->counters.onFree(blocks[k].second);
+			if (MemChunk* chunk = updateList(i, wasFree))
+				release.push_back(chunk);
+			list->lock.unlock();
+		}
+	}
+	for (MemChunk* chunk : release)
+		releaseChunk(chunk);
+}
+
+// @brief 内存回归到所属链表
+//     共享持有 _structMutex 保证链表不被摘除，只 try_lock 所属的那一张链表
+//     - 拿到锁:   归还并顺带合并其他线程推迟的归还
+//     - 锁被占用: 一次 CAS 压入待归还栈后直接返回，由下一个拿到该链表锁的线程合并
+//     所属块因此变为可归还时，放掉全部锁后再归还
+void MemPool::deallocateFromLists(uint8_t *address, ssize_t _size) {
+	MemChunk* release;
+	{
+		std::shared_lock<std::shared_mutex> structure(_structMutex);
+		int i = findList(address);
+		MemList* list = lists[i];
+		list->counters.onFree(_size);
+		if (!list->lock.try_lock()) {
+			list->pushPending(address, _size);
+			return;
+		}
+		bool wasFree = options.chunkLists > 0 && list->isFree();
+		list->deallocate(address, _size);
+		list->drainPending();
+		release = updateList(i, wasFree);
+		list->lock.unlock();
+	}
+	if (release)
+		releaseChunk(release);
 }
 
 // @brief 内存池打印
 // 横向打印 sizeLists 张表，每张表都是表现了每个空闲链表的节点信息
 void MemPool::print() const {
+	std::shared_lock<std::shared_mutex> structure(_structMutex);
 	std::cout << std::endl;
 	std::cout.setf(std::ios::left);
 
@@ -122,34 +421,484 @@ void MemPool::print() const {
 // @brief 表打印
 // 打印内存池中第 i 张表
 void MemPool::print(int i) const {
+	std::shared_lock<std::shared_mutex> structure(_structMutex);
 	lists[i]->print();
 }
 
 // @brief 内存配置
-//     扫描所有链表头，根据记录的表内最大空闲块来判断该表是否能分配 _size 内存
-//     如果可以，调用对应链表的 allocate(_size) 函数
+//     大对象单独映射，不占用链表
+//     小对象直接从 slab 层取，不进行链表查找
+//     否则在容量树上 O(log n) 找到能分配 _size 内存的链表（剩余空间还要能保存一个空闲节点）
+//     然后只锁这张链表调用它的 allocate(_size) 函数
+//     走哪一层只取决于 (_size, alignment)，回收时据此找回同一层
 // @parma _size 需求大小
+// @parma alignment 对齐要求（2 的幂次）
+//     - 大对象: 按页对齐，超过页大小时多映射一段再截掉前部
+//     - slab:   slab 页按 SLAB_ALIGN 对齐，对象大小是 alignment 倍数的级别才满足，不是就升级
+//     - 链表:   在空闲节点中切出对齐的一段，前后剩余部分仍留在链表中
 // @return
 //     - not nullptr: successfully
-//     - nullptr:     failure
-void *MemPool::allocate(ssize_t _size) {
-	// 为防止幻读需加锁
-	_mutex.lock();
-	for (int i = 0; i < this->sizeLists; i ++) {
-		if (_size <= lists[i]->maxSize && lists[i]->maxSize - _size >= sizeof(MemListNode)) {
-			void* ret = lists[i]->allocate(_size);
-			_mutex.unlock();
+//     - nullptr:     failure（alignment 不是 2 的幂次也失败）
+void *MemPool::allocate(ssize_t _size, ssize_t alignment) {
+	if (alignment <= 0 || (alignment & (alignment - 1))) {
+		counters.onFail();
+		return nullptr;
+	}
+	alignment = alignmentFor(_size, alignment);
+	void* ret;
+	int cls = slabClass(_size, alignment);
+	if (largeThreshold != -1 && _size >= largeThreshold) {
+		ret = allocateLarge(_size, alignment);
+	} else if (cls != -1) {
+		std::lock_guard<std::mutex> guard(_slabMutex);
+		ret = slabs.allocate(cls);
+	} else {
+		ret = allocateFromLists(_size, alignment);
+	}
+	recordAllocate(_size, ret);
+	if (MemProfiler* p = profiler.load(std::memory_order_relaxed)) [[unlikely]] {
+		if (ret)
+			p->onAllocate(ret, _size);
+	}
+	return ret;
+}
+
+// @brief 原地调整已配置块的大小
+//     新旧大小必须落在同一层（由 (size, alignment) 决定），否则回收时会找错层，直接失败
+//     - 大对象: 映射本身够大，或 mremap 能原地扩展
+//     - slab:   新旧大小属于同一级
+//     - 链表:   锁住所属链表，由链表在相邻空闲空间上伸缩
+// @parma alignment 与配置时一致
+// @return 是否成功；成功后按 newSize 回收
+bool MemPool::tryExpand(uint8_t *address, ssize_t oldSize, ssize_t newSize, ssize_t alignment) {
+	if (newSize == oldSize)
+		return true;
+	ssize_t oldAlign = alignmentFor(oldSize, alignment);
+	ssize_t newAlign = alignmentFor(newSize, alignment);
+	if (newAlign != oldAlign && (uintptr_t)address % newAlign != 0)
+		return false;
+	bool oldLarge = largeThreshold != -1 && oldSize >= largeThreshold;
+	bool newLarge = largeThreshold != -1 && newSize >= largeThreshold;
+	int oldCls = slabClass(oldSize, oldAlign);
+	int newCls = slabClass(newSize, newAlign);
+	bool ok;
+	if (oldLarge || newLarge)
+		ok = oldLarge && newLarge && tryExpandLarge(address, newSize);
+	else if (oldCls != -1 || newCls != -1)
+		ok = oldCls == newCls;
+	else
+		ok = newSize >= (ssize_t)sizeof(MemListNode) && tryExpandInList(address, oldSize, newSize);
+	if (ok) {
+		counters.onResize(oldSize, newSize);
+		if (MemProfiler* p = profiler.load(std::memory_order_relaxed)) [[unlikely]]
+			p->onResize(address, newSize);
+	}
+	return ok;
+}
+
+// @brief 重新配置
+//     能原地调整就不移动；否则配置新块、复制 min(oldSize, newSize) 字节后回收旧块
+// @return 新地址，失败为 nullptr（旧块保持不变）
+void *MemPool::reallocate(uint8_t *address, ssize_t oldSize, ssize_t newSize, ssize_t alignment) {
+	if (address == nullptr)
+		return allocate(newSize, alignment);
+	if (tryExpand(address, oldSize, newSize, alignment))
+		return address;
+	void* ret = allocate(newSize, alignment);
+	if (ret == nullptr)
+		return nullptr;
+	memcpy(ret, address, std::min(oldSize, newSize));
+	deallocate(address, oldSize, alignment);
+	return ret;
+}
+
+// @brief 在所属链表上原地伸缩（阻塞加锁，先合并待归还栈，让刚归还的邻居也能用上）
+bool MemPool::tryExpandInList(uint8_t *address, ssize_t oldSize, ssize_t newSize) {
+	bool ok;
+	MemChunk* release;
+	{
+		std::shared_lock<std::shared_mutex> structure(_structMutex);
+		int i = findList(address);
+		MemList* list = lists[i];
+		list->lock.lock();
+		list->drainPending();
+		ok = list->tryExpand(address, oldSize, newSize);
+		if (ok)
+			list->counters.onResize(oldSize, newSize);
+		release = updateList(i, false);
+		list->lock.unlock();
+	}
+	if (release)
+		releaseChunk(release);
+	return ok;
+}
+
+// @brief 实际使用的对齐：开启 cacheLineThreshold 时足够大的请求至少按缓存行对齐
+ssize_t MemPool::alignmentFor(ssize_t _size, ssize_t alignment) const {
+	if (options.cacheLineThreshold > 0 && _size >= options.cacheLineThreshold)
+		return std::max(alignment, MemPoolOptions::CACHE_LINE_SIZE);
+	return alignment;
+}
+
+// @brief 走 slab 层时的级别，大对象或不走 slab 为 -1
+int MemPool::slabClass(ssize_t _size, ssize_t alignment) const {
+	if (!useSlabs || (largeThreshold != -1 && _size >= largeThreshold))
+		return -1;
+	return SlabCache::classOf(_size, alignment);
+}
+
+// @brief 记录一次配置的结果与请求大小
+void MemPool::recordAllocate(ssize_t _size, void *ret) {
+	sizeHistogram[MemPoolStats::histogramBucket(_size)].fetch_add(1, std::memory_order_relaxed);
+	if (ret)
+		counters.onAllocate(_size);
+	else
+		counters.onFail();
+}
+
+// @brief 批量内存配置
+//     同样大小的 count 块，slab 层只加一次锁，链表上每张链表只加一次锁连续切出
+// @parma out 存放配置结果
+// @return 实际配置到的块数（不足 count 时内存池已没有空间；alignment 不是 2 的幂次时为 0）
+int MemPool::allocateBatch(int count, ssize_t _size, void **out, ssize_t alignment) {
+	if (alignment <= 0 || (alignment & (alignment - 1))) {
+		counters.onFail();
+		return 0;
+	}
+	int n = allocateMany(_size, alignment, count, out);
+	if (MemProfiler* p = profiler.load(std::memory_order_relaxed)) [[unlikely]] {
+		for (int i = 0; i < n; i ++)
+			p->onAllocate(out[i], _size);
+	}
+	return n;
+}
+
+// @brief 批量配置同样大小的 count 块，供线程缓存补充与 allocateBatch 使用
+//     大对象逐块映射；slab 层只加一次锁；其余见 allocateManyFromLists
+// @parma blocks 存放配置结果
+// @return 实际配置到的块数
+int MemPool::allocateMany(ssize_t _size, ssize_t alignment, int count, void **blocks) {
+	alignment = alignmentFor(_size, alignment);
+	int cls = slabClass(_size, alignment);
+	int n = 0;
+	if (largeThreshold != -1 && _size >= largeThreshold) {
+		while (n < count) {
+			blocks[n] = allocateLarge(_size, alignment);
+			recordAllocate(_size, blocks[n]);
+			if (blocks[n] == nullptr)
+				break;
+			n ++;
+		}
+		return n;
+	}
+	if (cls == -1) {
+		n = allocateManyFromLists(_size, alignment, count, blocks);
+		for (int i = 0; i < n; i ++)
+			recordAllocate(_size, blocks[i]);
+		if (n < count)
+			recordAllocate(_size, nullptr);
+		return n;
+	}
+	std::lock_guard<std::mutex> guard(_slabMutex);
+	while (n < count) {
+		blocks[n] = slabs.allocate(cls);
+		recordAllocate(_size, blocks[n]);
+		if (blocks[n] == nullptr)
+			break;
+		n ++;
+	}
+	return n;
+}
+
+// @brief 从空闲链表中配置
+//     容量树不含待归还栈中的块，找不到时先合并所有待归还栈再找一次
+//     仍然不够时，开启了扩容且一张新链表放得下就映射新块再试一次
+//     新块可能被其他线程抢先用掉，因此扩容成功就一直重试（容量树上的容量是可保证的下界，不会空转）
+// @parma alignment 大于 1 时调用链表的 allocateAligned，前后最多各剩下一个空闲节点
+void *MemPool::allocateFromLists(ssize_t _size, ssize_t alignment) {
+	ssize_t need = alignment > 1 ? _size + 2 * alignment + 2 * (ssize_t)sizeof(MemListNode)
+								 : _size + (ssize_t)sizeof(MemListNode);
+	while (true) {
+		void* ret;
+		std::vector<MemChunk*> release;
+		{
+			std::shared_lock<std::shared_mutex> structure(_structMutex);
+			ret = searchLists(_size, alignment, need, release);
+			if (ret == nullptr && drainLists(release))
+				ret = searchLists(_size, alignment, need, release);
+		}
+		for (MemChunk* chunk : release)
+			releaseChunk(chunk);
+		if (ret)
 			return ret;
+		if (options.chunkLists <= 0 || need > oneListSize || !grow(need))
+			break;
+	}
+	return nullptr;
+}
+
+// @brief 当前线程的轮转起点
+// 每个线程第一次配置时领一个编号并打散，让不同线程从不同的链表开始找
+static unsigned threadSlot() {
+	static std::atomic<unsigned> slots{0};
+	thread_local unsigned slot = slots.fetch_add(1, std::memory_order_relaxed) * 2654435761u;
+	return slot;
+}
+
+// @brief 从空闲链表中批量配置
+//     锁住一张候选链表后连续切块直到它放不下，再换下一张，每张链表只加一次锁
+//     候选链表一块也切不出时退回 allocateFromLists（合并待归还栈、扩容），仍失败就停止
+// @return 实际配置到的块数
+int MemPool::allocateManyFromLists(ssize_t _size, ssize_t alignment, int count, void **blocks) {
+	ssize_t need = alignment > 1 ? _size + 2 * alignment + 2 * (ssize_t)sizeof(MemListNode)
+								 : _size + (ssize_t)sizeof(MemListNode);
+	int n = 0;
+	while (n < count) {
+		int got = 0;
+		MemChunk* release = nullptr;
+		{
+			std::shared_lock<std::shared_mutex> structure(_structMutex);
+			int i = nextList(need, (int)(threadSlot() % (unsigned)sizeLists), -1);
+			if (i != -1) {
+				MemList* list = lists[i];
+				list->lock.lock();
+				bool wasFree = options.chunkLists > 0 && list->isFree();
+				list->drainPending();
+				for (; n < count; n ++, got ++) {
+					void* ret = alignment > 1 ? list->allocateAligned(_size, alignment) : list->allocate(_size);
+					if (ret == nullptr)
+						break;
+					list->counters.onAllocate(_size);
+					blocks[n] = ret;
+				}
+				release = updateList(i, wasFree);
+				list->lock.unlock();
+			}
+		}
+		if (release)
+			releaseChunk(release);
+		if (got == 0) {
+			if ((blocks[n] = allocateFromLists(_size, alignment)) == nullptr)
+				break;
+			n ++;
+		}
+	}
+	return n;
+}
+
+// @brief 在各链表中查找并配置（调用方共享持有 _structMutex）
+//     第一轮只 try_lock，被其他线程占用的链表直接跳过，换下一张候选
+//     第一轮有链表因被占用而跳过时，第二轮阻塞加锁，保证只要有链表放得下就能配置成功
+// @parma need    链表容量至少为 need
+// @parma release 收集合并待归还栈后变为可归还的块，由调用方放掉锁后归还
+void* MemPool::searchLists(ssize_t _size, ssize_t alignment, ssize_t need, std::vector<MemChunk*> &release) {
+	int start = (int)(threadSlot() % (unsigned)sizeLists);
+	for (int pass = 0; pass < 2; pass ++) {
+		bool skipped = false;
+		int i = -1;
+		for (int visited = 0; visited < sizeLists; visited ++) {
+			i = nextList(need, start, i);
+			if (i == -1)
+				break;
+			MemList* list = lists[i];
+			if (pass == 0 && !list->lock.try_lock()) {
+				skipped = true;
+				continue;
+			}
+			if (pass == 1)
+				list->lock.lock();
+			bool wasFree = options.chunkLists > 0 && list->isFree();
+			list->drainPending();
+			void* ret = alignment > 1 ? list->allocateAligned(_size, alignment) : list->allocate(_size);
+			if (ret)
+				list->counters.onAllocate(_size);
+			else
+				list->counters.onFail();
+			if (MemChunk* chunk = updateList(i, wasFree))
+				release.push_back(chunk);
+			list->lock.unlock();
+			// maxSize 只是下界估计的链表（如 TLSF）也可能分配失败，继续找后面的
+			if (ret)
+				return ret;
 		}
+		if (!skipped)
+			break;
 	}
-	_mutex.unlock();
 	return nullptr;
 }
 
+// @brief 阻塞地合并所有链表的待归还栈（调用方共享持有 _structMutex）
+// @parma release 收集因此变为可归还的块，由调用方放掉锁后归还
+// @return 是否合并了任何块
+bool MemPool::drainLists(std::vector<MemChunk*> &release) {
+	bool drained = false;
+	for (int i = 0; i < sizeLists; i ++) {
+		MemList* list = lists[i];
+		if (!list->hasPending())
+			continue;
+		list->lock.lock();
+		bool wasFree = options.chunkLists > 0 && list->isFree();
+		if (list->drainPending()) {
+			drained = true;
+			if (MemChunk* chunk = updateList(i, wasFree))
+				release.push_back(chunk);
+		}
+		list->lock.unlock();
+	}
+	return drained;
+}
+
+// @brief 按分配算法与轮转顺序给出下一张候选链表（在 _mutex 下查容量树）
+//     - prev == -1 时 BEST_FIT:  容量够用的链表中最小的
+//     - prev == -1 时 WORST_FIT: 容量最大的链表
+//     - 其余:                    从 prev 之后（prev == -1 时从 start）轮转找第一张容量够用的链表
+// @parma need 链表容量至少为 need
+// @return 链表下标，没有则为 -1
+int MemPool::nextList(ssize_t need, int start, int prev) {
+	std::lock_guard<std::mutex> guard(_mutex);
+	if (prev == -1) {
+		if (algorithm == BEST_FIT)
+			return capacity.bestFit(need);
+		if (algorithm == WORST_FIT)
+			return capacity.worstFit(need);
+		prev = start - 1;
+	}
+	int i = capacity.firstFit(need, prev + 1);
+	return i != -1 ? i : capacity.firstFit(need);
+}
+
+// @brief 大对象配置
+//     单独 mmap 一段（按页向上取整，遵循大页配置），记录到旁路表中
+//     alignment 超过页大小时多映射 alignment，截掉对齐位置之前的部分
+//     映射在锁外进行，只在登记时持有 _largeMutex
+void *MemPool::allocateLarge(ssize_t _size, ssize_t alignment) {
+	bool over = alignment > (ssize_t)sysconf(_SC_PAGESIZE);
+	ssize_t bytes = over ? _size + alignment : _size;
+	uint8_t* address = mapChunk(bytes);
+	if (address == nullptr)
+		return nullptr;
+	if (over) {
+		auto aligned = ((uintptr_t)address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		auto head = (ssize_t)(aligned - (uintptr_t)address);
+		if (head > 0)
+			munmap(address, head);
+		address += head;
+		bytes -= head;
+	}
+	std::lock_guard<std::mutex> guard(_largeMutex);
+	largeObjects[address] = bytes;
+	return address;
+}
+
+// @brief 大对象回收，从旁路表中注销后 munmap
+void MemPool::deallocateLarge(uint8_t *address) {
+	ssize_t bytes;
+	{
+		std::lock_guard<std::mutex> guard(_largeMutex);
+		auto it = largeObjects.find(address);
+		if (it == largeObjects.end()) {
+			std::cout << "Error: not a large object of this pool (in MemPool::deallocate)" << std::endl;
+			return;
+		}
+		bytes = it->second;
+		largeObjects.erase(it);
+	}
+	munmap(address, bytes);
+}
+
+// @brief 大对象原地伸缩
+//     映射按页取整，newSize 不超过映射大小时直接成功
+//     更大时尝试不移动地 mremap 扩展映射（后面的地址空间被占用则失败）
+bool MemPool::tryExpandLarge(uint8_t *address, ssize_t newSize) {
+	std::lock_guard<std::mutex> guard(_largeMutex);
+	auto it = largeObjects.find(address);
+	if (it == largeObjects.end())
+		return false;
+	if (newSize <= it->second)
+		return true;
+#ifdef __linux__
+	ssize_t pageSize = sysconf(_SC_PAGESIZE);
+	ssize_t bytes = (newSize + pageSize - 1) / pageSize * pageSize;
+	if (mremap(address, it->second, bytes, 0) != MAP_FAILED) {
+		it->second = bytes;
+		return true;
+	}
+#endif
+	return false;
+}
+
 ssize_t MemPool::getSizeLists() const {
+	std::shared_lock<std::shared_mutex> structure(_structMutex);
 	return sizeLists;
 }
 
 ssize_t MemPool::getOneListSize() const {
 	return oneListSize;
+}
+
+ssize_t MemPool::getSizeChunks() const {
+	std::shared_lock<std::shared_mutex> structure(_structMutex);
+	return (ssize_t)chunks.size();
+}
+
+// @brief 各链表锁的统计（按链表首地址顺序）
+// 竞争次数占加锁次数的比例偏高说明链表太少，可据此调整链表数量
+std::vector<ListLockStats> MemPool::getLockStats() const {
+	std::shared_lock<std::shared_mutex> structure(_structMutex);
+	std::vector<ListLockStats> ret;
+	ret.reserve(lists.size());
+	for (MemList* list : lists)
+		ret.push_back(list->lock.stats());
+	return ret;
+}
+
+// @brief 挂上采样分析器，nullptr 表示摘下
+//     挂上后经过本内存池（含线程缓存）的 配置/回收 都交给它采样
+//     分析器须比挂着它的时间活得更久；摘下后已在途的调用可能仍在使用它
+void MemPool::setProfiler(MemProfiler* _profiler) {
+	profiler.store(_profiler, std::memory_order_release);
+}
+
+MemProfiler* MemPool::getProfiler() const {
+	return profiler.load(std::memory_order_acquire);
+}
+
+// @brief 统计快照
+//     计数器直接读取；空闲块信息需逐张锁住链表遍历，代价与空闲块总数成正比
+//     待归还栈中的块已计入回收，但尚未计入空闲块
+MemPoolStats MemPool::getStats() const {
+	MemPoolStats ret;
+	ret.allocations = counters.allocations.load(std::memory_order_relaxed);
+	ret.frees = counters.frees.load(std::memory_order_relaxed);
+	ret.failedAllocations = counters.failedAllocations.load(std::memory_order_relaxed);
+	ret.bytesInUse = counters.bytesInUse.load(std::memory_order_relaxed);
+	ret.peakBytesInUse = counters.peakBytesInUse.load(std::memory_order_relaxed);
+	for (int i = 0; i < MemPoolStats::HISTOGRAM_BUCKETS; i ++)
+		ret.sizeHistogram[i] = sizeHistogram[i].load(std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> guard(_largeMutex);
+		ret.largeObjects = (ssize_t)largeObjects.size();
+	}
+	std::shared_lock<std::shared_mutex> structure(_structMutex);
+	ret.lists.resize(lists.size());
+	for (size_t i = 0; i < lists.size(); i ++) {
+		MemList* list = lists[i];
+		MemListStats& stats = ret.lists[i];
+		stats.allocations = list->counters.allocations.load(std::memory_order_relaxed);
+		stats.frees = list->counters.frees.load(std::memory_order_relaxed);
+		stats.failedAllocations = list->counters.failedAllocations.load(std::memory_order_relaxed);
+		stats.bytesInUse = list->counters.bytesInUse.load(std::memory_order_relaxed);
+		stats.peakBytesInUse = list->counters.peakBytesInUse.load(std::memory_order_relaxed);
+		list->lock.lock();
+		list->freeStats(stats);
+		list->lock.unlock();
+		if (stats.freeBytes > 0)
+			stats.fragmentation = 1.0 - (double)stats.largestFreeBlock / (double)stats.freeBytes;
+		ret.freeBlocks += stats.freeBlocks;
+		ret.freeBytes += stats.freeBytes;
+		ret.largestFreeBlock = std::max(ret.largestFreeBlock, stats.largestFreeBlock);
+	}
+	if (ret.freeBytes > 0)
+		ret.fragmentation = 1.0 - (double)ret.largestFreeBlock / (double)ret.freeBytes;
+	return ret;
 }
\ No newline at end of file
@@ -0,0 +1,232 @@
+#include "memprofiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <cxxabi.h>
+
+namespace {
+	thread_local bool started = false;	///< 本线程是否已经抽取过第一个间隔
+
+	// @brief 本线程的随机数发生器
+	std::mt19937_64& generator() {
+		thread_local std::mt19937_64 rng(std::random_device{}());
+		return rng;
+	}
+
+	// @brief 把一个栈帧解析为函数名：能找到符号就反修饰
+	//     找不到（可执行文件没有导出符号）时为 模块名+偏移，可用 addr2line -e 模块 偏移 还原；都不行时为十六进制地址
+	std::string resolve(void* frame) {
+		Dl_info info;
+		if (dladdr(frame, &info) != 0) {
+			if (info.dli_sname != nullptr) {
+				int status = 0;
+				char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+				std::string ret = status == 0 && demangled ? demangled : info.dli_sname;
+				free(demangled);
+				return ret;
+			}
+			if (info.dli_fname != nullptr && *info.dli_fname) {
+				const char* base = strrchr(info.dli_fname, '/');
+				char offset[32];
+				snprintf(offset, sizeof(offset), "+0x%zx", (size_t)((char*)frame - (char*)info.dli_fbase));
+				return std::string(base ? base + 1 : info.dli_fname) + offset;
+			}
+		}
+		char buf[32];
+		snprintf(buf, sizeof(buf), "%p", frame);
+		return buf;
+	}
+
+	// @brief 配置路径上内存池自身的函数（内存池、线程缓存、配置器、分析器），记录调用点时跳过
+	bool internalFrame(const std::string& name) {
+		static const char* const PREFIXES[] = {
+			"MemPool::", "ThreadCache::", "MemProfiler::", "MemPoolResource::",
+			"zyz::MemPool<", "zyz::Allocator<", "zyz::_allocate<", "zyz::_deallocate<",
+		};
+		// 模板函数反修饰后带返回类型，只看参数表之前的部分，且前缀须从一个名字的开头匹配
+		std::string head = name.substr(0, name.find('('));
+		for (const char* prefix : PREFIXES) {
+			size_t pos = head.find(prefix);
+			if (pos != std::string::npos && (pos == 0 || head[pos - 1] == ' ' || head[pos - 1] == '*' || head[pos - 1] == '&'))
+				return true;
+		}
+		return false;
+	}
+
+	// @brief 栈帧名字的缓存
+	struct Symbols {
+		std::unordered_map<void*, std::string> names;
+
+		const std::string& operator()(void* frame) {
+			auto it = names.find(frame);
+			if (it == names.end())
+				it = names.emplace(frame, resolve(frame)).first;
+			return it->second;
+		}
+	};
+
+	// @brief 去掉最内层属于内存池自身的栈帧，最内层即为真正的调用点（至少保留一帧）
+	std::vector<void*> callerFrames(const MemProfiler::Sample& s, Symbols& symbols) {
+		int first = 0;
+		while (first < s.depth - 1 && internalFrame(symbols(s.frames[first])))
+			first ++;
+		return std::vector<void*>(s.frames + first, s.frames + s.depth);
+	}
+
+	// @brief 折叠格式中 ';' 分隔栈帧、最后一个空格分隔数值
+	std::string foldedName(std::string name) {
+		std::replace(name.begin(), name.end(), ';', ':');
+		std::replace(name.begin(), name.end(), ' ', '_');
+		return name;
+	}
+}
+
+// @parma _sampleInterval 平均采样间隔（字节），越小越精确、开销越大
+MemProfiler::MemProfiler(ssize_t _sampleInterval) :
+		sampleInterval(std::max(_sampleInterval, (ssize_t)1)),
+		liveSamples(0) {}
+
+// @brief 倒计数减到 0 时调用：记录调用栈与大小，并为本线程抽取下一个间隔
+//     线程第一次到这里时倒计数还没有初始化，先抽一个间隔，减完仍未到 0 就不采样
+void MemProfiler::sample(void* address, ssize_t size) {
+	if (!started) {
+		started = true;
+		bytesUntilSample += nextInterval();
+		if (bytesUntilSample > 0)
+			return;
+	}
+	bytesUntilSample = nextInterval();
+	Sample s{};
+	s.size = size;
+	// 从调用 sample 的那一帧开始记录（backtrace 本身及其包装可能多出几帧）
+	void* frames[MAX_DEPTH + 4];
+	int depth = backtrace(frames, MAX_DEPTH + 4);
+	void* caller = __builtin_return_address(0);
+	int skip = 1;
+	for (int i = 0; i < std::min(depth, 4); i ++) {
+		if (frames[i] == caller) {
+			skip = i;
+			break;
+		}
+	}
+	s.depth = std::min(std::max(depth - skip, 0), MAX_DEPTH);
+	std::copy(frames + skip, frames + skip + s.depth, s.frames);
+	Shard& shard = shardOf(address);
+	std::lock_guard<std::mutex> guard(shard.lock);
+	if (shard.live.insert_or_assign(address, s).second)
+		liveSamples.fetch_add(1, std::memory_order_relaxed);
+}
+
+// @brief 回收的地址被采样过时从存活表中移除
+void MemProfiler::forget(void* address) {
+	Shard& shard = shardOf(address);
+	std::lock_guard<std::mutex> guard(shard.lock);
+	if (shard.live.erase(address))
+		liveSamples.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// @brief 原地调整大小：被采样过的块更新记录的大小
+void MemProfiler::onResize(void* address, ssize_t newSize) {
+	if (liveSamples.load(std::memory_order_relaxed) == 0)
+		return;
+	Shard& shard = shardOf(address);
+	std::lock_guard<std::mutex> guard(shard.lock);
+	auto it = shard.live.find(address);
+	if (it != shard.live.end())
+		it->second.size = newSize;
+}
+
+// @brief 存活采样的快照
+std::vector<MemProfiler::Sample> MemProfiler::snapshot() const {
+	std::vector<Sample> ret;
+	for (const Shard& shard : shards) {
+		std::lock_guard<std::mutex> guard(shard.lock);
+		for (auto& [address, s] : shard.live)
+			ret.push_back(s);
+	}
+	return ret;
+}
+
+// @brief 输出折叠栈格式（flamegraph.pl / speedscope 可直接读取）
+//     每行一个调用栈：从最外层到最内层用 ';' 连接，最后是估计的存活字节数
+//     最内层是调用内存池的位置，内存池自身的栈帧不列出
+void MemProfiler::dumpFolded(std::ostream& out) const {
+	Symbols symbols;
+	std::map<std::vector<void*>, double> stacks;
+	for (const Sample& s : snapshot())
+		stacks[callerFrames(s, symbols)] += weight(s.size);
+	for (auto& [frames, bytes] : stacks) {
+		for (int i = (int)frames.size() - 1; i >= 0; i --)
+			out << foldedName(symbols(frames[i])) << (i ? ";" : "");
+		out << " " << (uint64_t)std::llround(bytes) << "\n";
+	}
+}
+
+// @brief 输出 gperftools 的堆文件格式（pprof 可直接读取）
+//     heap_v2 格式给出采样到的原始 次数/字节 与采样间隔，由 pprof 按间隔还原
+//     只记录存活的采样，累计配置一栏与存活一栏相同，内存池自身的栈帧不列出；末尾附上 /proc/self/maps 供 pprof 符号化
+void MemProfiler::dumpPprof(std::ostream& out) const {
+	Symbols symbols;
+	std::map<std::vector<void*>, std::pair<uint64_t, uint64_t>> stacks;
+	uint64_t objects = 0, bytes = 0;
+	for (const Sample& s : snapshot()) {
+		auto& [n, b] = stacks[callerFrames(s, symbols)];
+		n ++;
+		b += s.size;
+		objects ++;
+		bytes += s.size;
+	}
+	out << "heap profile: " << objects << ": " << bytes << " [" << objects << ": " << bytes
+		<< "] @ heap_v2/" << sampleInterval << "\n";
+	for (auto& [frames, count] : stacks) {
+		out << count.first << ": " << count.second << " [" << count.first << ": " << count.second << "] @";
+		for (void* frame : frames)
+			out << " " << frame;
+		out << "\n";
+	}
+	out << "\nMAPPED_LIBRARIES:\n";
+	std::ifstream maps("/proc/self/maps");
+	out << maps.rdbuf();
+}
+
+ssize_t MemProfiler::getSampleInterval() const noexcept {
+	return sampleInterval;
+}
+
+ssize_t MemProfiler::getLiveSamples() const noexcept {
+	return liveSamples.load(std::memory_order_relaxed);
+}
+
+// @brief 由存活采样估计的存活字节数（每个采样按被采到的概率加权）
+double MemProfiler::estimateLiveBytes() const {
+	double ret = 0;
+	for (const Sample& s : snapshot())
+		ret += weight(s.size);
+	return ret;
+}
+
+// @brief 下一个采样间隔：均值为 sampleInterval 的指数分布
+ssize_t MemProfiler::nextInterval() const {
+	std::exponential_distribution<double> dist(1.0 / (double)sampleInterval);
+	return (ssize_t)dist(generator()) + 1;
+}
+
+// @brief 一个大小为 size 的采样代表的字节数：size / P(被采到)，P = 1 - e^(-size/interval)
+double MemProfiler::weight(ssize_t size) const {
+	double p = -std::expm1(-(double)size / (double)sampleInterval);
+	return p > 0 ? (double)size / p : (double)size;
+}
+
+// @brief 地址所在的存活表分片
+MemProfiler::Shard& MemProfiler::shardOf(void* address) const {
+	auto h = (uint64_t)(uintptr_t)address * 0x9e3779b97f4a7c15ull;
+	return shards[h >> 60 & (SHARDS - 1)];
+}
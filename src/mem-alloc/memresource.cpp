@@ -0,0 +1,57 @@
+#include "memresource.h"
+#include "mempool.h"
+
+#include <algorithm>
+#include <new>
+
+// @brief 向内存池申请的大小（至少能保存一个空闲节点）
+static ssize_t blockSize(std::size_t bytes) {
+	return (ssize_t)std::max(bytes, sizeof(MemListNode));
+}
+
+// @parma _pool 上游内存池
+MemPoolResource::MemPoolResource(MemPool* _pool) : pool(_pool) {}
+
+MemPool* MemPoolResource::getPool() const noexcept {
+	return pool;
+}
+
+// @brief 内存配置
+//     按 alignment 对齐向内存池申请
+//     内存池空间不足时按 memory_resource 的约定抛出 std::bad_alloc
+void* MemPoolResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+	void* ret = rawAllocate(bytes, alignment);
+	if (ret == nullptr)
+		throw std::bad_alloc();
+	return ret;
+}
+
+// @brief 内存回收，bytes 与 alignment 与配置时一致
+void MemPoolResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+	rawDeallocate(p, bytes, alignment);
+}
+
+// @brief 上游是同一个内存池的资源可以互相回收
+bool MemPoolResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+	auto* that = dynamic_cast<const MemPoolResource*>(&other);
+	return that != nullptr && that->pool == pool;
+}
+
+void* MemPoolResource::rawAllocate(std::size_t bytes, std::size_t alignment) {
+	return pool->allocate(blockSize(bytes), (ssize_t)alignment);
+}
+
+void MemPoolResource::rawDeallocate(void* p, std::size_t bytes, std::size_t alignment) {
+	pool->deallocate(reinterpret_cast<uint8_t*>(p), blockSize(bytes), (ssize_t)alignment);
+}
+
+// @parma _pool 上游内存池
+CachedMemPoolResource::CachedMemPoolResource(MemPool* _pool) : MemPoolResource(_pool) {}
+
+void* CachedMemPoolResource::rawAllocate(std::size_t bytes, std::size_t alignment) {
+	return ThreadCache::local(pool)->allocate(blockSize(bytes), (ssize_t)alignment);
+}
+
+void CachedMemPoolResource::rawDeallocate(void* p, std::size_t bytes, std::size_t alignment) {
+	ThreadCache::local(pool)->deallocate(p, blockSize(bytes), (ssize_t)alignment);
+}
@@ -0,0 +1,77 @@
+#include "memstats.h"
+
+#include <sstream>
+
+// @brief 记录一次成功配置，顺带更新峰值
+void MemCounters::onAllocate(ssize_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	updatePeak(bytesInUse.fetch_add(size, std::memory_order_relaxed) + size);
+}
+
+// @brief 记录一次回收
+void MemCounters::onFree(ssize_t size) {
+	frees.fetch_add(1, std::memory_order_relaxed);
+	bytesInUse.fetch_sub(size, std::memory_order_relaxed);
+}
+
+// @brief 记录一次配置失败
+void MemCounters::onFail() {
+	failedAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+// @brief 记录一次原地调整大小（不计入 配置/回收 次数）
+void MemCounters::onResize(ssize_t oldSize, ssize_t newSize) {
+	updatePeak(bytesInUse.fetch_add(newSize - oldSize, std::memory_order_relaxed) + newSize - oldSize);
+}
+
+// @brief 用 CAS 把峰值推高到 now
+void MemCounters::updatePeak(int64_t now) {
+	int64_t peak = peakBytesInUse.load(std::memory_order_relaxed);
+	while (now > peak && !peakBytesInUse.compare_exchange_weak(peak, now, std::memory_order_relaxed));
+}
+
+// @brief 请求大小所属的直方图桶：floor(log2(size))，超出的归入最后一桶
+int MemPoolStats::histogramBucket(ssize_t size) {
+	if (size <= 1)
+		return 0;
+	int bucket = 63 - __builtin_clzll((uint64_t)size);
+	return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+}
+
+// @brief 序列化为 JSON
+// 直方图只输出到最后一个非空桶
+std::string MemPoolStats::toJson() const {
+	std::ostringstream out;
+	out << "{\"allocations\":" << allocations
+		<< ",\"frees\":" << frees
+		<< ",\"failedAllocations\":" << failedAllocations
+		<< ",\"bytesInUse\":" << bytesInUse
+		<< ",\"peakBytesInUse\":" << peakBytesInUse
+		<< ",\"freeBlocks\":" << freeBlocks
+		<< ",\"freeBytes\":" << freeBytes
+		<< ",\"largestFreeBlock\":" << largestFreeBlock
+		<< ",\"fragmentation\":" << fragmentation
+		<< ",\"largeObjects\":" << largeObjects
+		<< ",\"sizeHistogram\":[";
+	int last = HISTOGRAM_BUCKETS - 1;
+	while (last >= 0 && sizeHistogram[last] == 0)
+		last --;
+	for (int i = 0; i <= last; i ++)
+		out << (i ? "," : "") << sizeHistogram[i];
+	out << "],\"lists\":[";
+	for (size_t i = 0; i < lists.size(); i ++) {
+		const MemListStats& list = lists[i];
+		out << (i ? "," : "")
+			<< "{\"allocations\":" << list.allocations
+			<< ",\"frees\":" << list.frees
+			<< ",\"failedAllocations\":" << list.failedAllocations
+			<< ",\"bytesInUse\":" << list.bytesInUse
+			<< ",\"peakBytesInUse\":" << list.peakBytesInUse
+			<< ",\"freeBlocks\":" << list.freeBlocks
+			<< ",\"freeBytes\":" << list.freeBytes
+			<< ",\"largestFreeBlock\":" << list.largestFreeBlock
+			<< ",\"fragmentation\":" << list.fragmentation << "}";
+	}
+	out << "]}";
+	return out.str();
+}
@@ -0,0 +1,284 @@
+#include "persistentpool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr uint64_t POOL_MAGIC   = 0x4c4f4f50505a595aull;	///< "ZYZPPOOL"
+static constexpr uint32_t POOL_VERSION = 1;
+
+// @brief 根表中的一项，offset 为 0 表示空位
+struct PersistentRoot {
+	char     name[PersistentPool::ROOT_NAME];
+	uint64_t offset;
+};
+
+// @brief 文件头，位于文件开头，只含偏移不含地址
+struct PersistentPool::Header {
+	uint64_t magic;		///< POOL_MAGIC
+	uint32_t version;	///< POOL_VERSION
+	uint32_t opened;	///< 打开期间为 1，正常析构时清 0；打开时仍为 1 说明上次没有正常关闭
+	uint64_t bytes;		///< 文件大小
+	uint64_t freeHead;	///< 第一个空闲块的偏移，0 表示没有
+	uint64_t usedBytes;	///< 已配置的字节数
+	PersistentRoot roots[MAX_ROOTS];	///< 根表
+};
+
+// @brief 空闲块头，存放在空闲块的开头
+struct PersistentPool::FreeNode {
+	uint64_t size;	///< 空闲块大小（含块头）
+	uint64_t next;	///< 下一个空闲块的偏移，0 表示没有
+};
+
+static uint64_t roundUp(uint64_t x, uint64_t a) {
+	return (x + a - 1) / a * a;
+}
+
+// @brief 打开或新建持久化内存池
+//     文件不存在或为空时新建：扩展到 _bytes（按页向上取整），整个数据区作为一个空闲块
+//     文件已存在时映射整个文件并校验文件头；_bytes 大于文件时扩大文件，新空间并入空闲链表
+//     映射地址由系统决定，每次都可能不同
+//     打开期间对文件加独占的 flock，另一个进程（或本进程的另一个池）再打开同一个文件会失败
+//     上次没有正常关闭（进程崩溃）时检查空闲链表，配置/回收中途崩溃留下的残缺链表会被拒绝
+// @parma _path  文件路径
+// @parma _bytes 池的大小
+//    - 打开/映射失败、文件已被打开、文件头不符或空闲链表损坏: failure
+//    - else:                                                    successful
+PersistentPool::PersistentPool(const std::string& _path, ssize_t _bytes) :
+		path(_path),
+		fd(-1),
+		base(nullptr),
+		bytes(0),
+		reopened(false) {
+	fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd == -1) {
+		std::cout << "Error: cannot open " << path << " (in construct of PersistentPool)" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	// 先加锁再读大小：不能改动别的进程正在使用的文件
+	if (flock(fd, LOCK_EX | LOCK_NB) == -1) {
+		std::cout << "Error: " << path << " is already opened by another pool (in construct of PersistentPool)" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	struct stat st{};
+	if (fstat(fd, &st) == -1) {
+		std::cout << "Error: cannot open " << path << " (in construct of PersistentPool)" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	ssize_t pageSize = sysconf(_SC_PAGESIZE);
+	ssize_t oldBytes = st.st_size;
+	reopened = oldBytes > 0;
+	bytes = std::max(oldBytes, (ssize_t)roundUp(std::max(_bytes, (ssize_t)dataOffset() + GRANULARITY), pageSize));
+	if (bytes > oldBytes && ftruncate(fd, bytes) == -1) {
+		std::cout << "Error: cannot resize " << path << " (in construct of PersistentPool)" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	void* pos = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (pos == MAP_FAILED) {
+		std::cout << "Error: cannot map " << path << " (in construct of PersistentPool)" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	base = reinterpret_cast<uint8_t*>(pos);
+	Header* h = header();
+	if (!reopened) {
+		memset(h, 0, dataOffset());
+		h->magic = POOL_MAGIC;
+		h->version = POOL_VERSION;
+		h->bytes = bytes;
+		insertFree(dataOffset(), bytes - dataOffset());
+		h->opened = 1;
+		return;
+	}
+	if (oldBytes < (ssize_t)dataOffset() || h->magic != POOL_MAGIC || h->version != POOL_VERSION || (ssize_t)h->bytes != oldBytes) {
+		std::cout << "Error: " << path << " is not a compatible pool file (in construct of PersistentPool)" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	if (h->opened && !checkFreeList()) {
+		std::cout << "Error: " << path << " was not closed cleanly and its free list is damaged (in construct of PersistentPool)" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	h->opened = 1;
+	if (bytes > oldBytes) {
+		h->bytes = bytes;
+		insertFree(oldBytes, bytes - oldBytes);
+	}
+}
+
+// @brief 标记为正常关闭，解除映射并关闭文件（同时释放文件锁），数据留在文件中（需要落盘时先调用 flush）
+PersistentPool::~PersistentPool() {
+	header()->opened = 0;
+	munmap(base, bytes);
+	close(fd);
+}
+
+// @brief 内存配置
+//     首次适应：找到第一个能切出对齐位置的空闲块，从它前部切出，前后剩余部分仍是空闲块
+// @parma _size     需求大小（按 GRANULARITY 向上取整）
+// @parma alignment 对齐要求（2 的幂次，不超过一页，映射基址只保证按页对齐）
+// @return
+//     - not nullptr: successfully
+//     - nullptr:     空间不足或 alignment 不合法
+void* PersistentPool::allocate(ssize_t _size, ssize_t alignment) {
+	if (alignment <= 0 || (alignment & (alignment - 1)) || alignment > sysconf(_SC_PAGESIZE))
+		return nullptr;
+	auto size = roundUp(std::max(_size, (ssize_t)1), GRANULARITY);
+	auto align = (uint64_t)std::max(alignment, GRANULARITY);
+	std::lock_guard<std::mutex> guard(_mutex);
+	for (uint64_t prev = 0, cur = header()->freeHead; cur; prev = cur, cur = node(cur)->next) {
+		FreeNode* p = node(cur);
+		uint64_t at = roundUp(cur, align);
+		if (at + size > cur + p->size)
+			continue;
+		uint64_t tail = cur + p->size - (at + size);
+		uint64_t next = p->next;
+		if (tail > 0) {
+			node(at + size)->size = tail;
+			node(at + size)->next = next;
+			next = at + size;
+		}
+		if (at > cur) {
+			p->size = at - cur;
+			p->next = next;
+		} else {
+			link(prev) = next;
+		}
+		header()->usedBytes += size;
+		return base + at;
+	}
+	return nullptr;
+}
+
+// @brief 内存回归，按地址插回空闲链表并与前后相邻的空闲块合并
+// @parma _size     与配置时一致
+// @parma alignment 与配置时一致（不影响回收）
+void PersistentPool::deallocate(uint8_t *address, ssize_t _size, ssize_t /*alignment*/) {
+	auto size = roundUp(std::max(_size, (ssize_t)1), GRANULARITY);
+	std::lock_guard<std::mutex> guard(_mutex);
+	header()->usedBytes -= size;
+	insertFree(address - base, size);
+}
+
+// @brief 把 [offset, offset + size) 按地址插回空闲链表并合并（调用方持有 _mutex 或尚未共享）
+void PersistentPool::insertFree(uint64_t offset, uint64_t size) {
+	uint64_t prev = 0, cur = header()->freeHead;
+	while (cur && cur < offset) {
+		prev = cur;
+		cur = node(cur)->next;
+	}
+	FreeNode* p = node(offset);
+	p->size = size;
+	p->next = cur;
+	if (cur && offset + size == cur) {
+		p->size += node(cur)->size;
+		p->next = node(cur)->next;
+	}
+	if (prev && prev + node(prev)->size == offset) {
+		node(prev)->size += p->size;
+		node(prev)->next = p->next;
+	} else {
+		link(prev) = offset;
+	}
+}
+
+// @brief 登记一个根，重新打开后用 getRoot 按名字取回
+// @parma address 池中的地址，nullptr 表示删除该根
+// @return 名字过长或根表已满时为 false
+bool PersistentPool::setRoot(const std::string& name, const void* address) {
+	if (name.empty() || name.size() >= ROOT_NAME)
+		return false;
+	std::lock_guard<std::mutex> guard(_mutex);
+	int i = findRoot(name);
+	if (i == -1) {
+		if (address == nullptr)
+			return true;
+		for (i = 0; i < MAX_ROOTS && header()->roots[i].offset != 0; i ++);
+		if (i == MAX_ROOTS)
+			return false;
+		memset(header()->roots[i].name, 0, ROOT_NAME);
+		memcpy(header()->roots[i].name, name.data(), name.size());
+	}
+	header()->roots[i].offset = address ? (uint64_t)(reinterpret_cast<const uint8_t*>(address) - base) : 0;
+	return true;
+}
+
+// @brief 按名字取回根在本次映射下的地址，没有则为 nullptr
+void* PersistentPool::getRoot(const std::string& name) const {
+	std::lock_guard<std::mutex> guard(_mutex);
+	int i = findRoot(name);
+	return i == -1 ? nullptr : base + header()->roots[i].offset;
+}
+
+// @brief 同步落盘
+void PersistentPool::flush() {
+	std::lock_guard<std::mutex> guard(_mutex);
+	msync(base, bytes, MS_SYNC);
+}
+
+// @brief 是否打开的是已有的池（否则为新建）
+bool PersistentPool::isReopened() const noexcept {
+	return reopened;
+}
+
+uint8_t* PersistentPool::getBase() const noexcept {
+	return base;
+}
+
+ssize_t PersistentPool::getBytes() const noexcept {
+	return bytes;
+}
+
+ssize_t PersistentPool::getUsedBytes() const {
+	std::lock_guard<std::mutex> guard(_mutex);
+	return (ssize_t)header()->usedBytes;
+}
+
+// @brief 第一个块的偏移：文件头之后按缓存行对齐（偏移 0 因此可以表示空）
+uint64_t PersistentPool::dataOffset() {
+	static_assert(sizeof(FreeNode) <= GRANULARITY, "a free block must hold its node");
+	return roundUp(sizeof(Header), 64);
+}
+
+PersistentPool::Header* PersistentPool::header() const {
+	return reinterpret_cast<Header*>(base);
+}
+
+PersistentPool::FreeNode* PersistentPool::node(uint64_t offset) const {
+	return reinterpret_cast<FreeNode*>(base + offset);
+}
+
+// @brief 指向 prev 之后那个空闲块的链接（prev 为 0 时是链表头）
+uint64_t& PersistentPool::link(uint64_t prev) const {
+	return prev ? node(prev)->next : header()->freeHead;
+}
+
+// @brief 检查空闲链表：块在数据区内、按 GRANULARITY 对齐、按地址升序且互不重叠，空闲字节加已配置字节恰为数据区大小
+//     配置/回收都只改动少数几个字段，中途崩溃会破坏其中某一条
+bool PersistentPool::checkFreeList() const {
+	const Header* h = header();
+	uint64_t end = h->bytes, last = dataOffset(), freeBytes = 0;
+	for (uint64_t cur = h->freeHead; cur; cur = node(cur)->next) {
+		if (cur < last || cur % GRANULARITY || cur + sizeof(FreeNode) > end)
+			return false;
+		uint64_t size = node(cur)->size;
+		if (size == 0 || size % GRANULARITY || size > end - cur)
+			return false;
+		freeBytes += size;
+		last = cur + size;
+	}
+	return freeBytes + h->usedBytes == end - dataOffset();
+}
+
+// @brief 根表中名字为 name 的下标，没有则为 -1
+int PersistentPool::findRoot(const std::string& name) const {
+	for (int i = 0; i < MAX_ROOTS; i ++) {
+		const PersistentRoot& root = header()->roots[i];
+		if (root.offset != 0 && strncmp(root.name, name.c_str(), ROOT_NAME) == 0)
+			return i;
+	}
+	return -1;
+}
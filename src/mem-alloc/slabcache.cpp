@@ -0,0 +1,163 @@
+#include "slabcache.h"
+#include "mempool.h"
+
+#include <vector>
+
+// @brief 构造
+// @parma _pool slab 页的来源，调用 allocate/deallocate 时需已持有其 _slabMutex
+SlabCache::SlabCache(MemPool* _pool) : pool(_pool) {
+	for (int i = 0; i < NUM_CLASSES; i ++) {
+		classes[i].partial = nullptr;
+		classes[i].empty = nullptr;
+		classes[i].capacity = (int)(SLAB_SIZE / classSize(i));
+	}
+}
+
+// @brief 请求大小所属的级别
+// @return 级别下标，超过 MAX_CLASS_SIZE 为 -1
+int SlabCache::classOf(ssize_t size) {
+	if (size <= 16)
+		return 0;
+	if (size <= 128)
+		return (int)((size + 15) >> 4) - 1;
+	if (size <= 256)
+		return 8 + (int)((size - 129) >> 5);
+	if (size <= MAX_CLASS_SIZE)
+		return 12 + (int)((size - 257) >> 6);
+	return -1;
+}
+
+// @brief 满足对齐要求的级别
+//     slab 页按 SLAB_ALIGN 对齐，对象大小是 alignment 倍数的级别里所有对象都对齐
+//     从 classOf(size) 开始向上找第一个这样的级别
+// @return 级别下标，超过 MAX_CLASS_SIZE 或 alignment 超过 SLAB_ALIGN 为 -1
+int SlabCache::classOf(ssize_t size, ssize_t alignment) {
+	int cls = classOf(size);
+	if (cls == -1 || alignment > SLAB_ALIGN)
+		return -1;
+	while (cls < NUM_CLASSES && classSize(cls) % alignment != 0)
+		cls ++;
+	return cls < NUM_CLASSES ? cls : -1;
+}
+
+// @brief 级别对应的对象大小
+ssize_t SlabCache::classSize(int cls) {
+	if (cls < 8)
+		return (cls + 1) << 4;
+	if (cls < 12)
+		return 128 + ((cls - 7) << 5);
+	return 256 + ((cls - 11) << 6);
+}
+
+// @brief 对象配置
+//     从未满的 slab 中取：先取回收链表，再从未切分部分切
+//     没有未满的 slab 就用备用空 slab，再没有就向内存池要一页
+// @parma cls 级别
+// @return
+//     - not nullptr: successfully
+//     - nullptr:     内存池已经给不出整页
+void* SlabCache::allocate(int cls) {
+	SizeClass& c = classes[cls];
+	Slab* slab = c.partial;
+	if (slab == nullptr) {
+		if (c.empty) {
+			slab = c.empty;
+			c.empty = nullptr;
+		} else {
+			auto* page = (uint8_t *)pool->allocateFromLists(SLAB_SIZE, SLAB_ALIGN);
+			if (page == nullptr)
+				return nullptr;
+			slab = new Slab{page, 0, nullptr, page, nullptr, nullptr};
+			auto pageNo = (uintptr_t)page / SLAB_SIZE;
+			pageIndex[pageNo << 1 | 1] = slab;
+			pageIndex[((uintptr_t)page + SLAB_SIZE - 1) / SLAB_SIZE << 1] = slab;
+		}
+		linkPartial(c, slab);
+	}
+	void* ret;
+	if (slab->freeList) {
+		ret = slab->freeList;
+		slab->freeList = slab->freeList->next;
+	} else {
+		ret = slab->bumpPos;
+		slab->bumpPos += classSize(cls);
+	}
+	if (++ slab->used == c.capacity)
+		unlinkPartial(c, slab);
+	return ret;
+}
+
+// @brief 对象回收
+//     挂到所属 slab 的回收链表；slab 由满变为未满时重新挂回未满链表
+//     slab 变空时留作备用，已有备用的就还给内存池
+void SlabCache::deallocate(int cls, void* address) {
+	SizeClass& c = classes[cls];
+	Slab* slab = findSlab(address);
+	auto* obj = reinterpret_cast<FreeObject*>(address);
+	obj->next = slab->freeList;
+	slab->freeList = obj;
+	if (slab->used -- == c.capacity)
+		linkPartial(c, slab);
+	if (slab->used == 0) {
+		unlinkPartial(c, slab);
+		if (c.empty) {
+			freeSlab(slab);
+		} else {
+			slab->freeList = nullptr;
+			slab->bumpPos = slab->base;
+			c.empty = slab;
+		}
+	}
+}
+
+// @brief 把所有 slab 页还给内存池（其中的对象都将失效）
+void SlabCache::release() {
+	std::vector<Slab*> all;
+	for (auto& [key, slab] : pageIndex) {
+		if (key & 1)
+			all.push_back(slab);
+	}
+	for (Slab* slab : all)
+		freeSlab(slab);
+	for (SizeClass& c : classes)
+		c.partial = c.empty = nullptr;
+}
+
+// @brief 由对象地址找到所属 slab，O(1)
+//     先看从对象所在页开始的 slab，对象在它之前就属于在该页结束的 slab
+SlabCache::Slab* SlabCache::findSlab(void* address) const {
+	auto pageNo = (uintptr_t)address / SLAB_SIZE;
+	auto it = pageIndex.find(pageNo << 1 | 1);
+	if (it != pageIndex.end() && (uint8_t *)address >= it->second->base)
+		return it->second;
+	return pageIndex.find(pageNo << 1)->second;
+}
+
+// @brief 挂到未满链表头
+void SlabCache::linkPartial(SizeClass& c, Slab* slab) {
+	slab->prev = nullptr;
+	slab->next = c.partial;
+	if (c.partial)
+		c.partial->prev = slab;
+	c.partial = slab;
+}
+
+// @brief 从未满链表摘下
+void SlabCache::unlinkPartial(SizeClass& c, Slab* slab) {
+	if (slab->prev)
+		slab->prev->next = slab->next;
+	else
+		c.partial = slab->next;
+	if (slab->next)
+		slab->next->prev = slab->prev;
+	slab->prev = slab->next = nullptr;
+}
+
+// @brief 注销 slab 并把整页还给内存池
+void SlabCache::freeSlab(Slab* slab) {
+	auto pageNo = (uintptr_t)slab->base / SLAB_SIZE;
+	pageIndex.erase(pageNo << 1 | 1);
+	pageIndex.erase(((uintptr_t)slab->base + SLAB_SIZE - 1) / SLAB_SIZE << 1);
+	pool->deallocateFromLists(slab->base, SLAB_SIZE);
+	delete slab;
+}
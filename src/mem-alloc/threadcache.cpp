@@ -0,0 +1,252 @@
+#include "threadcache.h"
+#include "mempool.h"
+
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+namespace {
+	std::mutex registryMutex;	///< 保护 registry、直通缓存表以及各缓存与内存池的绑定关系
+
+	// @brief 所有存活的线程缓存
+	// 不析构：进程退出时全局容器的析构可能晚于本文件的静态对象，那时仍要注册/注销缓存
+	std::vector<ThreadCache*>& registry() {
+		static auto* caches = new std::vector<ThreadCache*>;
+		return *caches;
+	}
+
+	// @brief 当前线程持有的全部缓存（每个内存池一份）
+	// 线程退出时析构，把缓存块还给各自的内存池
+	struct LocalCaches {
+		std::vector<ThreadCache*> caches;
+		ThreadCache*              last = nullptr;	///< 最近使用的缓存，绝大多数情况下直接命中
+
+		~LocalCaches();
+	};
+	thread_local LocalCaches localCaches;
+	thread_local bool        localCachesGone = false;	///< 本线程的缓存已析构（之后析构的 thread_local/全局容器还会回收）
+
+	LocalCaches::~LocalCaches() {
+		for (ThreadCache* cache : caches)
+			delete cache;
+		localCachesGone = true;
+	}
+}
+
+// @brief 构造并登记到全局表中
+// @parma _pool 绑定的内存池
+ThreadCache::ThreadCache(MemPool* _pool, bool _direct) : pool(_pool), direct(_direct) {
+	for (Magazine& m : magazines)
+		m.count = 0;
+	std::lock_guard<std::mutex> guard(registryMutex);
+	registry().push_back(this);
+}
+
+// @brief 析构
+// 内存池尚在则把缓存块全部还回去，然后从全局表中注销
+ThreadCache::~ThreadCache() {
+	std::lock_guard<std::mutex> guard(registryMutex);
+	if (pool.load(std::memory_order_relaxed))
+		flush();
+	registry().erase(std::find(registry().begin(), registry().end(), this));
+}
+
+// @brief 获取当前线程在 _pool 上的缓存，没有则新建
+// 顺带回收已经与内存池脱离的缓存
+ThreadCache* ThreadCache::local(MemPool* _pool) {
+	if (localCachesGone) [[unlikely]]
+		return directCache(_pool);
+	LocalCaches& lc = localCaches;
+	if (lc.last && lc.last->pool.load(std::memory_order_relaxed) == _pool)
+		return lc.last;
+	lc.last = nullptr;
+	for (size_t i = 0; i < lc.caches.size(); i ++) {
+		ThreadCache* cache = lc.caches[i];
+		if (cache->pool.load(std::memory_order_relaxed) == _pool) {
+			lc.last = cache;
+			return cache;
+		}
+		if (cache->pool.load(std::memory_order_relaxed) == nullptr) {
+			delete cache;
+			lc.caches.erase(lc.caches.begin() + i --);
+		}
+	}
+	lc.last = new ThreadCache(_pool);
+	lc.caches.push_back(lc.last);
+	return lc.last;
+}
+
+// @brief 获取 _pool 的直通缓存，没有则新建
+// 线程的缓存析构后仍有回收（如全局容器在进程退出时析构）就用它：不存块，所有线程共用，不再释放
+ThreadCache* ThreadCache::directCache(MemPool* _pool) {
+	static auto* caches = new std::vector<ThreadCache*>;
+	{
+		std::lock_guard<std::mutex> guard(registryMutex);
+		for (ThreadCache* cache : *caches)
+			if (cache->pool.load(std::memory_order_relaxed) == _pool)
+				return cache;
+	}
+	ThreadCache* cache = new ThreadCache(_pool, true);
+	std::lock_guard<std::mutex> guard(registryMutex);
+	caches->push_back(cache);
+	return cache;
+}
+
+// @brief 内存池析构时调用，让所有线程里绑定它的缓存失效
+// 缓存中的块属于即将释放的内存，直接丢弃
+void ThreadCache::detach(MemPool* _pool) {
+	std::lock_guard<std::mutex> guard(registryMutex);
+	for (ThreadCache* cache : registry()) {
+		if (cache->pool.load(std::memory_order_relaxed) == _pool) {
+			for (Magazine& m : cache->magazines)
+				m.count = 0;
+			cache->pool.store(nullptr, std::memory_order_relaxed);
+		}
+	}
+}
+
+// @brief 计算 size 所属级别的块大小
+ssize_t ThreadCache::classSize(ssize_t size) {
+	if (size <= CLASS_GRANULARITY)
+		return CLASS_GRANULARITY;
+	return (size + CLASS_GRANULARITY - 1) / CLASS_GRANULARITY * CLASS_GRANULARITY;
+}
+
+// @brief 内存配置
+//     超过 MAX_CACHED_SIZE 或对齐要求超过 CLASS_GRANULARITY 的直接转给内存池
+//     否则从对应级别取一块，取空了先批量补充
+// @parma size 需求大小
+// @parma alignment 对齐要求
+// @return
+//     - not nullptr: successfully
+//     - nullptr:     内存池也没有空间了
+void* ThreadCache::allocate(ssize_t size, ssize_t alignment) {
+	if (size > MAX_CACHED_SIZE || alignment > CLASS_GRANULARITY)
+		return pool.load(std::memory_order_relaxed)->allocate(size, alignment);
+	void* ret;
+	if (direct) [[unlikely]] {
+		if (pool.load(std::memory_order_relaxed)->allocateMany(classSize(size), CLASS_GRANULARITY, 1, &ret) == 0)
+			return nullptr;
+	} else {
+		int cls = (int)(classSize(size) / CLASS_GRANULARITY) - 1;
+		Magazine& m = magazines[cls];
+		if (m.count == 0) {
+			refill(cls);
+			if (m.count == 0)
+				return nullptr;
+		}
+		ret = m.blocks[-- m.count];
+	}
+	if (MemProfiler* p = pool.load(std::memory_order_relaxed)->profiler.load(std::memory_order_relaxed)) [[unlikely]]
+		p->onAllocate(ret, size);
+	return ret;
+}
+
+// @brief 内存回收
+//     超过 MAX_CACHED_SIZE 或对齐要求超过 CLASS_GRANULARITY 的直接转给内存池
+//     否则放回对应级别，满了先批量归还一半
+// @parma address 回收首地址
+// @parma size    回收大小（与配置时一致）
+// @parma alignment 对齐要求（与配置时一致）
+void ThreadCache::deallocate(void* address, ssize_t size, ssize_t alignment) {
+	if (size > MAX_CACHED_SIZE || alignment > CLASS_GRANULARITY) {
+		pool.load(std::memory_order_relaxed)->deallocate((uint8_t *)address, size, alignment);
+		return;
+	}
+	if (MemProfiler* p = pool.load(std::memory_order_relaxed)->profiler.load(std::memory_order_relaxed)) [[unlikely]]
+		p->onFree(address);
+	if (direct) [[unlikely]] {
+		pool.load(std::memory_order_relaxed)->deallocateMany(&address, 1, classSize(size), CLASS_GRANULARITY);
+		return;
+	}
+	int cls = (int)(classSize(size) / CLASS_GRANULARITY) - 1;
+	Magazine& m = magazines[cls];
+	if (m.count == MAGAZINE_SIZE)
+		release(cls, BATCH_SIZE);
+	m.blocks[m.count ++] = address;
+}
+
+// @brief 原地调整已配置块的大小
+//     缓存范围内只有新旧大小同级才成功（块本来就是按级别大小配置的）
+//     一边在缓存范围内、一边不在时回收会走错路径，直接失败
+//     都不在缓存范围内的交给内存池
+bool ThreadCache::tryExpand(void* address, ssize_t oldSize, ssize_t newSize, ssize_t alignment) {
+	bool oldCached = oldSize <= MAX_CACHED_SIZE && alignment <= CLASS_GRANULARITY;
+	bool newCached = newSize <= MAX_CACHED_SIZE && alignment <= CLASS_GRANULARITY;
+	if (oldCached || newCached) {
+		if (!oldCached || !newCached || classSize(oldSize) != classSize(newSize))
+			return false;
+		if (MemProfiler* p = pool.load(std::memory_order_relaxed)->profiler.load(std::memory_order_relaxed)) [[unlikely]]
+			p->onResize(address, newSize);
+		return true;
+	}
+	return pool.load(std::memory_order_relaxed)->tryExpand((uint8_t *)address, oldSize, newSize, alignment);
+}
+
+// @brief 批量内存配置
+//     先取对应级别中缓存的块，不够的部分按级别大小直接向内存池批量配置（不经过缓存）
+//     不在缓存范围内的整批转给内存池
+// @parma out 存放配置结果
+// @return 实际配置到的块数
+int ThreadCache::allocateBatch(int count, ssize_t size, void** out, ssize_t alignment) {
+	if (size > MAX_CACHED_SIZE || alignment > CLASS_GRANULARITY)
+		return pool.load(std::memory_order_relaxed)->allocateBatch(count, size, out, alignment);
+	int cls = (int)(classSize(size) / CLASS_GRANULARITY) - 1;
+	Magazine& m = magazines[cls];
+	int n = 0;
+	while (n < count && m.count > 0)
+		out[n ++] = m.blocks[-- m.count];
+	if (n < count)
+		n += pool.load(std::memory_order_relaxed)->allocateMany(classSize(size), CLASS_GRANULARITY, count - n, out + n);
+	if (MemProfiler* p = pool.load(std::memory_order_relaxed)->profiler.load(std::memory_order_relaxed)) [[unlikely]] {
+		for (int i = 0; i < n; i ++)
+			p->onAllocate(out[i], size);
+	}
+	return n;
+}
+
+// @brief 批量内存回收
+//     先放回对应级别直到装满，其余按级别大小直接批量还给内存池
+//     不在缓存范围内的整批转给内存池
+// @parma size 各块大小（与配置时一致）
+void ThreadCache::deallocateBatch(void** blocks, int count, ssize_t size, ssize_t alignment) {
+	if (size > MAX_CACHED_SIZE || alignment > CLASS_GRANULARITY) {
+		std::vector<ssize_t> sizes(count, size);
+		pool.load(std::memory_order_relaxed)->deallocateBatch(blocks, sizes.data(), count, alignment);
+		return;
+	}
+	if (MemProfiler* p = pool.load(std::memory_order_relaxed)->profiler.load(std::memory_order_relaxed)) [[unlikely]] {
+		for (int i = 0; i < count; i ++)
+			p->onFree(blocks[i]);
+	}
+	int cls = (int)(classSize(size) / CLASS_GRANULARITY) - 1;
+	Magazine& m = magazines[cls];
+	int n = 0;
+	while (!direct && n < count && m.count < MAGAZINE_SIZE)
+		m.blocks[m.count ++] = blocks[n ++];
+	if (n < count)
+		pool.load(std::memory_order_relaxed)->deallocateMany(blocks + n, count - n, classSize(size), CLASS_GRANULARITY);
+}
+
+// @brief 把所有缓存块还给内存池
+void ThreadCache::flush() {
+	for (int cls = 0; cls < NUM_CLASSES; cls ++)
+		release(cls, magazines[cls].count);
+}
+
+// @brief 从内存池批量配置 BATCH_SIZE 块到 cls 级（按 CLASS_GRANULARITY 对齐）
+void ThreadCache::refill(int cls) {
+	ssize_t size = (cls + 1) * CLASS_GRANULARITY;
+	Magazine& m = magazines[cls];
+	m.count += pool.load(std::memory_order_relaxed)->allocateMany(size, CLASS_GRANULARITY, BATCH_SIZE - m.count, m.blocks + m.count);
+}
+
+// @brief 把 cls 级栈顶的 count 块批量还给内存池
+void ThreadCache::release(int cls, int count) {
+	if (count == 0)
+		return;
+	ssize_t size = (cls + 1) * CLASS_GRANULARITY;
+	Magazine& m = magazines[cls];
+	m.count -= count;
+	pool.load(std::memory_order_relaxed)->deallocateMany(m.blocks + m.count, count, size, CLASS_GRANULARITY);
+}
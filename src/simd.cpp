@@ -0,0 +1,536 @@
+#include "simd.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86 1
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#define TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+
+namespace {
+
+	// @brief 一个级别的全部内核
+	struct Kernels {
+		const int32_t* (*find32) (const int32_t*, const int32_t*, int32_t);
+		const float*   (*findF) (const float*, const float*, float);
+		ptrdiff_t (*count32) (const int32_t*, const int32_t*, int32_t);
+		ptrdiff_t (*countF) (const float*, const float*, float);
+		int32_t (*min32) (const int32_t*, const int32_t*);
+		float   (*minF) (const float*, const float*);
+		int32_t (*max32) (const int32_t*, const int32_t*);
+		float   (*maxF) (const float*, const float*);
+		int64_t (*sum32) (const int32_t*, const int32_t*);
+		float   (*sumF) (const float*, const float*);
+	};
+
+	// 计数时每个 32 位通道最多累加这么多次就并入 64 位总数
+	constexpr ptrdiff_t COUNT_BLOCK = (ptrdiff_t)1 << 24;
+
+	/* ---------------- 标量 ---------------- */
+
+	template<class T>
+	const T* findScalar (const T* first, const T* last, T value) {
+		for (; first != last; first ++)
+			if (*first == value)
+				return first;
+		return last;
+	}
+
+	template<class T>
+	ptrdiff_t countScalar (const T* first, const T* last, T value) {
+		ptrdiff_t ret = 0;
+		for (; first != last; first ++)
+			ret += *first == value;
+		return ret;
+	}
+
+	// 浮点数的最值跳过 NaN（ret != ret 即 ret 为 NaN），全是 NaN 时才得到 NaN；整数的 ret != ret 恒为假
+	template<class T>
+	T minOf (T a, T b) {
+		return (b < a || a != a) ? b : a;
+	}
+
+	template<class T>
+	T maxOf (T a, T b) {
+		return (a < b || a != a) ? b : a;
+	}
+
+	template<class T>
+	T minScalar (const T* first, const T* last) {
+		T ret = *first;
+		for (first ++; first != last; first ++)
+			ret = minOf(ret, *first);
+		return ret;
+	}
+
+	template<class T>
+	T maxScalar (const T* first, const T* last) {
+		T ret = *first;
+		for (first ++; first != last; first ++)
+			ret = maxOf(ret, *first);
+		return ret;
+	}
+
+	// @brief 第一个不是 NaN 的值，全是 NaN 时为 NaN；作为浮点最值累加器的初值
+	float firstNumber (const float* first, const float* last) {
+		for (; first != last; first ++)
+			if (*first == *first)
+				return *first;
+		return *(last - 1);
+	}
+
+	int64_t sumScalar32 (const int32_t* first, const int32_t* last) {
+		int64_t ret = 0;
+		for (; first != last; first ++)
+			ret += *first;
+		return ret;
+	}
+
+	float sumScalarF (const float* first, const float* last) {
+		float ret = 0;
+		for (; first != last; first ++)
+			ret += *first;
+		return ret;
+	}
+
+	const Kernels SCALAR_KERNELS = {
+		findScalar<int32_t>, findScalar<float>,
+		countScalar<int32_t>, countScalar<float>,
+		minScalar<int32_t>, minScalar<float>,
+		maxScalar<int32_t>, maxScalar<float>,
+		sumScalar32, sumScalarF,
+	};
+
+#ifdef SIMD_X86
+
+	/* ---------------- SSE4.2（128 位，4 路） ---------------- */
+
+	TARGET_SSE42 const int32_t* findSse32 (const int32_t* first, const int32_t* last, int32_t value) {
+		__m128i key = _mm_set1_epi32(value);
+		for (; last - first >= 16; first += 16) {
+			__m128i a = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)first), key);
+			__m128i b = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(first + 4)), key);
+			__m128i c = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(first + 8)), key);
+			__m128i d = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(first + 12)), key);
+			__m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+			if (!_mm_testz_si128(any, any))
+				break;
+		}
+		for (; last - first >= 4; first += 4) {
+			int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)first), key)));
+			if (mask)
+				return first + __builtin_ctz(mask);
+		}
+		return findScalar(first, last, value);
+	}
+
+	TARGET_SSE42 const float* findSseF (const float* first, const float* last, float value) {
+		__m128 key = _mm_set1_ps(value);
+		for (; last - first >= 16; first += 16) {
+			__m128 a = _mm_cmpeq_ps(_mm_loadu_ps(first), key);
+			__m128 b = _mm_cmpeq_ps(_mm_loadu_ps(first + 4), key);
+			__m128 c = _mm_cmpeq_ps(_mm_loadu_ps(first + 8), key);
+			__m128 d = _mm_cmpeq_ps(_mm_loadu_ps(first + 12), key);
+			if (_mm_movemask_ps(_mm_or_ps(_mm_or_ps(a, b), _mm_or_ps(c, d))))
+				break;
+		}
+		for (; last - first >= 4; first += 4) {
+			int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(first), key));
+			if (mask)
+				return first + __builtin_ctz(mask);
+		}
+		return findScalar(first, last, value);
+	}
+
+	// 比较结果为 -1 / 0，直接从计数通道里减掉
+	TARGET_SSE42 ptrdiff_t countSse32 (const int32_t* first, const int32_t* last, int32_t value) {
+		__m128i key = _mm_set1_epi32(value);
+		ptrdiff_t ret = 0;
+		while (last - first >= 8) {
+			const int32_t* stop = first + std::min((last - first) & ~(ptrdiff_t)7, COUNT_BLOCK);
+			__m128i a = _mm_setzero_si128(), b = _mm_setzero_si128();
+			for (; first != stop; first += 8) {
+				a = _mm_sub_epi32(a, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)first), key));
+				b = _mm_sub_epi32(b, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(first + 4)), key));
+			}
+			alignas(16) int32_t lanes[4];
+			_mm_store_si128((__m128i*)lanes, _mm_add_epi32(a, b));
+			ret += (ptrdiff_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+		}
+		return ret + countScalar(first, last, value);
+	}
+
+	TARGET_SSE42 ptrdiff_t countSseF (const float* first, const float* last, float value) {
+		__m128 key = _mm_set1_ps(value);
+		ptrdiff_t ret = 0;
+		while (last - first >= 8) {
+			const float* stop = first + std::min((last - first) & ~(ptrdiff_t)7, COUNT_BLOCK);
+			__m128i a = _mm_setzero_si128(), b = _mm_setzero_si128();
+			for (; first != stop; first += 8) {
+				a = _mm_sub_epi32(a, _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(first), key)));
+				b = _mm_sub_epi32(b, _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(first + 4), key)));
+			}
+			alignas(16) int32_t lanes[4];
+			_mm_store_si128((__m128i*)lanes, _mm_add_epi32(a, b));
+			ret += (ptrdiff_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+		}
+		return ret + countScalar(first, last, value);
+	}
+
+	TARGET_SSE42 int32_t minSse32 (const int32_t* first, const int32_t* last) {
+		if (last - first < 8)
+			return minScalar(first, last);
+		__m128i a = _mm_loadu_si128((const __m128i*)first), b = _mm_loadu_si128((const __m128i*)(first + 4));
+		for (first += 8; last - first >= 8; first += 8) {
+			a = _mm_min_epi32(a, _mm_loadu_si128((const __m128i*)first));
+			b = _mm_min_epi32(b, _mm_loadu_si128((const __m128i*)(first + 4)));
+		}
+		alignas(16) int32_t lanes[4];
+		_mm_store_si128((__m128i*)lanes, _mm_min_epi32(a, b));
+		int32_t ret = minScalar(lanes, lanes + 4);
+		return first == last ? ret : std::min(ret, minScalar(first, last));
+	}
+
+	TARGET_SSE42 float minSseF (const float* first, const float* last) {
+		if (last - first < 8)
+			return minScalar(first, last);
+		// 有一个操作数是 NaN 时返回第二个操作数：累加器放在第二个，读到的 NaN 就被跳过
+		__m128 a = _mm_set1_ps(firstNumber(first, last)), b = a;
+		for (; last - first >= 8; first += 8) {
+			a = _mm_min_ps(_mm_loadu_ps(first), a);
+			b = _mm_min_ps(_mm_loadu_ps(first + 4), b);
+		}
+		alignas(16) float lanes[4];
+		_mm_store_ps(lanes, _mm_min_ps(a, b));
+		float ret = minScalar(lanes, lanes + 4);
+		return first == last ? ret : minOf(ret, minScalar(first, last));
+	}
+
+	TARGET_SSE42 int32_t maxSse32 (const int32_t* first, const int32_t* last) {
+		if (last - first < 8)
+			return maxScalar(first, last);
+		__m128i a = _mm_loadu_si128((const __m128i*)first), b = _mm_loadu_si128((const __m128i*)(first + 4));
+		for (first += 8; last - first >= 8; first += 8) {
+			a = _mm_max_epi32(a, _mm_loadu_si128((const __m128i*)first));
+			b = _mm_max_epi32(b, _mm_loadu_si128((const __m128i*)(first + 4)));
+		}
+		alignas(16) int32_t lanes[4];
+		_mm_store_si128((__m128i*)lanes, _mm_max_epi32(a, b));
+		int32_t ret = maxScalar(lanes, lanes + 4);
+		return first == last ? ret : std::max(ret, maxScalar(first, last));
+	}
+
+	TARGET_SSE42 float maxSseF (const float* first, const float* last) {
+		if (last - first < 8)
+			return maxScalar(first, last);
+		// 有一个操作数是 NaN 时返回第二个操作数：累加器放在第二个，读到的 NaN 就被跳过
+		__m128 a = _mm_set1_ps(firstNumber(first, last)), b = a;
+		for (; last - first >= 8; first += 8) {
+			a = _mm_max_ps(_mm_loadu_ps(first), a);
+			b = _mm_max_ps(_mm_loadu_ps(first + 4), b);
+		}
+		alignas(16) float lanes[4];
+		_mm_store_ps(lanes, _mm_max_ps(a, b));
+		float ret = maxScalar(lanes, lanes + 4);
+		return first == last ? ret : maxOf(ret, maxScalar(first, last));
+	}
+
+	// 每 4 个 int32_t 符号扩展成两组 64 位再累加
+	TARGET_SSE42 int64_t sumSse32 (const int32_t* first, const int32_t* last) {
+		__m128i a = _mm_setzero_si128(), b = _mm_setzero_si128();
+		for (; last - first >= 4; first += 4) {
+			__m128i x = _mm_loadu_si128((const __m128i*)first);
+			a = _mm_add_epi64(a, _mm_cvtepi32_epi64(x));
+			b = _mm_add_epi64(b, _mm_cvtepi32_epi64(_mm_srli_si128(x, 8)));
+		}
+		alignas(16) int64_t lanes[2];
+		_mm_store_si128((__m128i*)lanes, _mm_add_epi64(a, b));
+		return lanes[0] + lanes[1] + sumScalar32(first, last);
+	}
+
+	TARGET_SSE42 float sumSseF (const float* first, const float* last) {
+		__m128 a = _mm_setzero_ps(), b = _mm_setzero_ps(), c = _mm_setzero_ps(), d = _mm_setzero_ps();
+		for (; last - first >= 16; first += 16) {
+			a = _mm_add_ps(a, _mm_loadu_ps(first));
+			b = _mm_add_ps(b, _mm_loadu_ps(first + 4));
+			c = _mm_add_ps(c, _mm_loadu_ps(first + 8));
+			d = _mm_add_ps(d, _mm_loadu_ps(first + 12));
+		}
+		alignas(16) float lanes[4];
+		_mm_store_ps(lanes, _mm_add_ps(_mm_add_ps(a, b), _mm_add_ps(c, d)));
+		return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumScalarF(first, last);
+	}
+
+	const Kernels SSE42_KERNELS = {
+		findSse32, findSseF,
+		countSse32, countSseF,
+		minSse32, minSseF,
+		maxSse32, maxSseF,
+		sumSse32, sumSseF,
+	};
+
+	/* ---------------- AVX2（256 位，8 路） ---------------- */
+
+	TARGET_AVX2 const int32_t* findAvx32 (const int32_t* first, const int32_t* last, int32_t value) {
+		__m256i key = _mm256_set1_epi32(value);
+		for (; last - first >= 32; first += 32) {
+			__m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)first), key);
+			__m256i b = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(first + 8)), key);
+			__m256i c = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(first + 16)), key);
+			__m256i d = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(first + 24)), key);
+			__m256i any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+			if (!_mm256_testz_si256(any, any))
+				break;
+		}
+		for (; last - first >= 8; first += 8) {
+			int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)first), key)));
+			if (mask)
+				return first + __builtin_ctz(mask);
+		}
+		return findScalar(first, last, value);
+	}
+
+	TARGET_AVX2 const float* findAvxF (const float* first, const float* last, float value) {
+		__m256 key = _mm256_set1_ps(value);
+		for (; last - first >= 32; first += 32) {
+			__m256 a = _mm256_cmp_ps(_mm256_loadu_ps(first), key, _CMP_EQ_OQ);
+			__m256 b = _mm256_cmp_ps(_mm256_loadu_ps(first + 8), key, _CMP_EQ_OQ);
+			__m256 c = _mm256_cmp_ps(_mm256_loadu_ps(first + 16), key, _CMP_EQ_OQ);
+			__m256 d = _mm256_cmp_ps(_mm256_loadu_ps(first + 24), key, _CMP_EQ_OQ);
+			if (_mm256_movemask_ps(_mm256_or_ps(_mm256_or_ps(a, b), _mm256_or_ps(c, d))))
+				break;
+		}
+		for (; last - first >= 8; first += 8) {
+			int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(first), key, _CMP_EQ_OQ));
+			if (mask)
+				return first + __builtin_ctz(mask);
+		}
+		return findScalar(first, last, value);
+	}
+
+	// @brief 8 个 32 位通道求和
+	TARGET_AVX2 ptrdiff_t laneSum (__m256i acc) {
+		alignas(32) int32_t lanes[8];
+		_mm256_store_si256((__m256i*)lanes, acc);
+		ptrdiff_t ret = 0;
+		for (int32_t lane : lanes)
+			ret += lane;
+		return ret;
+	}
+
+	TARGET_AVX2 ptrdiff_t countAvx32 (const int32_t* first, const int32_t* last, int32_t value) {
+		__m256i key = _mm256_set1_epi32(value);
+		ptrdiff_t ret = 0;
+		while (last - first >= 16) {
+			const int32_t* stop = first + std::min((last - first) & ~(ptrdiff_t)15, COUNT_BLOCK);
+			__m256i a = _mm256_setzero_si256(), b = _mm256_setzero_si256();
+			for (; first != stop; first += 16) {
+				a = _mm256_sub_epi32(a, _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)first), key));
+				b = _mm256_sub_epi32(b, _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(first + 8)), key));
+			}
+			ret += laneSum(_mm256_add_epi32(a, b));
+		}
+		return ret + countScalar(first, last, value);
+	}
+
+	TARGET_AVX2 ptrdiff_t countAvxF (const float* first, const float* last, float value) {
+		__m256 key = _mm256_set1_ps(value);
+		ptrdiff_t ret = 0;
+		while (last - first >= 16) {
+			const float* stop = first + std::min((last - first) & ~(ptrdiff_t)15, COUNT_BLOCK);
+			__m256i a = _mm256_setzero_si256(), b = _mm256_setzero_si256();
+			for (; first != stop; first += 16) {
+				a = _mm256_sub_epi32(a, _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(first), key, _CMP_EQ_OQ)));
+				b = _mm256_sub_epi32(b, _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(first + 8), key, _CMP_EQ_OQ)));
+			}
+			ret += laneSum(_mm256_add_epi32(a, b));
+		}
+		return ret + countScalar(first, last, value);
+	}
+
+	TARGET_AVX2 int32_t minAvx32 (const int32_t* first, const int32_t* last) {
+		if (last - first < 16)
+			return minScalar(first, last);
+		__m256i a = _mm256_loadu_si256((const __m256i*)first), b = _mm256_loadu_si256((const __m256i*)(first + 8));
+		for (first += 16; last - first >= 16; first += 16) {
+			a = _mm256_min_epi32(a, _mm256_loadu_si256((const __m256i*)first));
+			b = _mm256_min_epi32(b, _mm256_loadu_si256((const __m256i*)(first + 8)));
+		}
+		alignas(32) int32_t lanes[8];
+		_mm256_store_si256((__m256i*)lanes, _mm256_min_epi32(a, b));
+		int32_t ret = minScalar(lanes, lanes + 8);
+		return first == last ? ret : std::min(ret, minScalar(first, last));
+	}
+
+	TARGET_AVX2 float minAvxF (const float* first, const float* last) {
+		if (last - first < 16)
+			return minScalar(first, last);
+		// 有一个操作数是 NaN 时返回第二个操作数：累加器放在第二个，读到的 NaN 就被跳过
+		__m256 a = _mm256_set1_ps(firstNumber(first, last)), b = a;
+		for (; last - first >= 16; first += 16) {
+			a = _mm256_min_ps(_mm256_loadu_ps(first), a);
+			b = _mm256_min_ps(_mm256_loadu_ps(first + 8), b);
+		}
+		alignas(32) float lanes[8];
+		_mm256_store_ps(lanes, _mm256_min_ps(a, b));
+		float ret = minScalar(lanes, lanes + 8);
+		return first == last ? ret : minOf(ret, minScalar(first, last));
+	}
+
+	TARGET_AVX2 int32_t maxAvx32 (const int32_t* first, const int32_t* last) {
+		if (last - first < 16)
+			return maxScalar(first, last);
+		__m256i a = _mm256_loadu_si256((const __m256i*)first), b = _mm256_loadu_si256((const __m256i*)(first + 8));
+		for (first += 16; last - first >= 16; first += 16) {
+			a = _mm256_max_epi32(a, _mm256_loadu_si256((const __m256i*)first));
+			b = _mm256_max_epi32(b, _mm256_loadu_si256((const __m256i*)(first + 8)));
+		}
+		alignas(32) int32_t lanes[8];
+		_mm256_store_si256((__m256i*)lanes, _mm256_max_epi32(a, b));
+		int32_t ret = maxScalar(lanes, lanes + 8);
+		return first == last ? ret : std::max(ret, maxScalar(first, last));
+	}
+
+	TARGET_AVX2 float maxAvxF (const float* first, const float* last) {
+		if (last - first < 16)
+			return maxScalar(first, last);
+		// 有一个操作数是 NaN 时返回第二个操作数：累加器放在第二个，读到的 NaN 就被跳过
+		__m256 a = _mm256_set1_ps(firstNumber(first, last)), b = a;
+		for (; last - first >= 16; first += 16) {
+			a = _mm256_max_ps(_mm256_loadu_ps(first), a);
+			b = _mm256_max_ps(_mm256_loadu_ps(first + 8), b);
+		}
+		alignas(32) float lanes[8];
+		_mm256_store_ps(lanes, _mm256_max_ps(a, b));
+		float ret = maxScalar(lanes, lanes + 8);
+		return first == last ? ret : maxOf(ret, maxScalar(first, last));
+	}
+
+	TARGET_AVX2 int64_t sumAvx32 (const int32_t* first, const int32_t* last) {
+		__m256i a = _mm256_setzero_si256(), b = _mm256_setzero_si256();
+		for (; last - first >= 8; first += 8) {
+			a = _mm256_add_epi64(a, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)first)));
+			b = _mm256_add_epi64(b, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(first + 4))));
+		}
+		alignas(32) int64_t lanes[4];
+		_mm256_store_si256((__m256i*)lanes, _mm256_add_epi64(a, b));
+		return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumScalar32(first, last);
+	}
+
+	TARGET_AVX2 float sumAvxF (const float* first, const float* last) {
+		__m256 a = _mm256_setzero_ps(), b = _mm256_setzero_ps(), c = _mm256_setzero_ps(), d = _mm256_setzero_ps();
+		for (; last - first >= 32; first += 32) {
+			a = _mm256_add_ps(a, _mm256_loadu_ps(first));
+			b = _mm256_add_ps(b, _mm256_loadu_ps(first + 8));
+			c = _mm256_add_ps(c, _mm256_loadu_ps(first + 16));
+			d = _mm256_add_ps(d, _mm256_loadu_ps(first + 24));
+		}
+		alignas(32) float lanes[8];
+		_mm256_store_ps(lanes, _mm256_add_ps(_mm256_add_ps(a, b), _mm256_add_ps(c, d)));
+		float ret = 0;
+		for (float lane : lanes)
+			ret += lane;
+		return ret + sumScalarF(first, last);
+	}
+
+	const Kernels AVX2_KERNELS = {
+		findAvx32, findAvxF,
+		countAvx32, countAvxF,
+		minAvx32, minAvxF,
+		maxAvx32, maxAvxF,
+		sumAvx32, sumAvxF,
+	};
+
+#endif
+
+	std::atomic<const Kernels*> active{nullptr};	///< 当前使用的内核，首次调用时选定
+
+	const Kernels* kernelsOf (int level) {
+#ifdef SIMD_X86
+		if (level >= zyz::simd::LEVEL_AVX2)
+			return &AVX2_KERNELS;
+		if (level >= zyz::simd::LEVEL_SSE42)
+			return &SSE42_KERNELS;
+#endif
+		return &SCALAR_KERNELS;
+	}
+
+	const Kernels& kernels () {
+		const Kernels* k = active.load(std::memory_order_acquire);
+		if (k == nullptr) [[unlikely]] {
+			k = kernelsOf(zyz::simd::detectLevel());
+			active.store(k, std::memory_order_release);
+		}
+		return *k;
+	}
+}
+
+int zyz::simd::detectLevel() {
+#ifdef SIMD_X86
+	static const int level = __builtin_cpu_supports("avx2") ? LEVEL_AVX2 :
+	                         __builtin_cpu_supports("sse4.2") ? LEVEL_SSE42 : LEVEL_SCALAR;
+	return level;
+#else
+	return LEVEL_SCALAR;
+#endif
+}
+
+int zyz::simd::getLevel() {
+	const Kernels* k = &kernels();
+#ifdef SIMD_X86
+	if (k == &AVX2_KERNELS)
+		return LEVEL_AVX2;
+	if (k == &SSE42_KERNELS)
+		return LEVEL_SSE42;
+#endif
+	return LEVEL_SCALAR;
+}
+
+int zyz::simd::setLevel(int level) {
+	level = std::max(LEVEL_SCALAR, std::min(level, detectLevel()));
+	active.store(kernelsOf(level), std::memory_order_release);
+	return level;
+}
+
+const int32_t* zyz::simd::find(const int32_t* first, const int32_t* last, int32_t value) {
+	return kernels().find32(first, last, value);
+}
+
+const float* zyz::simd::find(const float* first, const float* last, float value) {
+	return kernels().findF(first, last, value);
+}
+
+ptrdiff_t zyz::simd::count(const int32_t* first, const int32_t* last, int32_t value) {
+	return kernels().count32(first, last, value);
+}
+
+ptrdiff_t zyz::simd::count(const float* first, const float* last, float value) {
+	return kernels().countF(first, last, value);
+}
+
+int32_t zyz::simd::minValue(const int32_t* first, const int32_t* last) {
+	return kernels().min32(first, last);
+}
+
+float zyz::simd::minValue(const float* first, const float* last) {
+	return kernels().minF(first, last);
+}
+
+int32_t zyz::simd::maxValue(const int32_t* first, const int32_t* last) {
+	return kernels().max32(first, last);
+}
+
+float zyz::simd::maxValue(const float* first, const float* last) {
+	return kernels().maxF(first, last);
+}
+
+int64_t zyz::simd::sum(const int32_t* first, const int32_t* last) {
+	return kernels().sum32(first, last);
+}
+
+float zyz::simd::sum(const float* first, const float* last) {
+	return kernels().sumF(first, last);
+}